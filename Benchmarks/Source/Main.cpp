@@ -0,0 +1,663 @@
+/*
+  ==============================================================================
+
+	Microbenchmarks for the plugin's hot paths.
+
+	SimpleEQBenchmarks [--json] [--output=<file>] [--iterations=<n>]
+
+	Results are written as CSV (or JSON with --json) to stdout or --output,
+	one row per benchmark/variant, with times in microseconds per call.
+	Exits with 1 if a fast approximation drifts too far from its reference,
+	or if the matched peak design stops beating the bilinear one.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/PluginEditor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+struct BenchmarkResult
+{
+	juce::String name, variant;
+	int iterations;
+	double meanMicroseconds, medianMicroseconds, minMicroseconds;
+};
+
+struct BenchmarkRunner
+{
+	explicit BenchmarkRunner(int baseIterations) : iterations(baseIterations) {}
+
+	/*
+	 times 'function' iterations * iterationScale times, after a short warm up.
+	 */
+	template<typename Function>
+	void run(const juce::String& name, const juce::String& variant, float iterationScale, Function&& function)
+	{
+		const auto numIterations = juce::jmax(10, juce::roundToInt(iterations * iterationScale));
+
+		for (int i = 0; i < numIterations / 10; ++i)
+			function();
+
+		std::vector<double> times;
+		times.reserve((size_t)numIterations);
+
+		for (int i = 0; i < numIterations; ++i)
+		{
+			auto start = juce::Time::getHighResolutionTicks();
+			function();
+			auto end = juce::Time::getHighResolutionTicks();
+
+			times.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6);
+		}
+
+		std::sort(times.begin(), times.end());
+
+		BenchmarkResult result;
+		result.name = name;
+		result.variant = variant;
+		result.iterations = numIterations;
+		result.meanMicroseconds = std::accumulate(times.begin(), times.end(), 0.0) / (double)times.size();
+		result.medianMicroseconds = times[times.size() / 2];
+		result.minMicroseconds = times.front();
+
+		std::cerr << name << " [" << variant << "] " << juce::String(result.medianMicroseconds, 3) << " us" << std::endl;
+		results.push_back(result);
+	}
+
+	juce::String toCSV() const
+	{
+		juce::String csv("benchmark,variant,iterations,mean_us,median_us,min_us\n");
+
+		for (auto& r : results)
+		{
+			csv << r.name << "," << r.variant << "," << r.iterations << ","
+				<< juce::String(r.meanMicroseconds, 4) << ","
+				<< juce::String(r.medianMicroseconds, 4) << ","
+				<< juce::String(r.minMicroseconds, 4) << "\n";
+		}
+
+		return csv;
+	}
+
+	juce::String toJSON() const
+	{
+		juce::Array<juce::var> rows;
+
+		for (auto& r : results)
+		{
+			auto* row = new juce::DynamicObject();
+			row->setProperty("benchmark", r.name);
+			row->setProperty("variant", r.variant);
+			row->setProperty("iterations", r.iterations);
+			row->setProperty("mean_us", r.meanMicroseconds);
+			row->setProperty("median_us", r.medianMicroseconds);
+			row->setProperty("min_us", r.minMicroseconds);
+			rows.add(juce::var(row));
+		}
+
+		return juce::JSON::toString(juce::var(rows));
+	}
+
+	int iterations;
+	std::vector<BenchmarkResult> results;
+};
+
+//==============================================================================
+static void fillWithNoise(juce::AudioBuffer<float>& buffer)
+{
+	juce::Random random(0x5eed);
+
+	for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+	{
+		auto* data = buffer.getWritePointer(ch);
+		for (int i = 0; i < buffer.getNumSamples(); ++i)
+			data[i] = random.nextFloat() * 2.f - 1.f;
+	}
+}
+
+static void setParameter(SimpleEQAudioProcessor& processor, const juce::String& paramID, float value)
+{
+	auto* param = processor.apvts.getParameter(paramID);
+	param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+//every biquad in the chain active, so the numbers are the worst case
+static void useAllBands(SimpleEQAudioProcessor& processor)
+{
+	using SEP = SimpleEQAudioProcessor;
+
+	setParameter(processor, SEP::paramLowCutFreq, 80.f);
+	setParameter(processor, SEP::paramLowCutSlope, (float)Slope::Slope_48);
+	setParameter(processor, SEP::paramHighCutFreq, 12000.f);
+	setParameter(processor, SEP::paramHighCutSlope, (float)Slope::Slope_48);
+	setParameter(processor, SEP::paramPeakGain, 6.f);
+}
+
+static void prepare(SimpleEQAudioProcessor& processor, double sampleRate, int blockSize)
+{
+	processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+	processor.prepareToPlay(sampleRate, blockSize);
+}
+
+using ProcessorCallback = std::function<void(SimpleEQAudioProcessor&)>;
+
+/*
+ times processBlock on a stereo noise buffer with every band active.
+ 'configure' sets parameters before prepareToPlay, 'beforeEachBlock' runs ahead of every timed block.
+ */
+static void benchmarkProcessBlockVariant(BenchmarkRunner& runner, const juce::String& name, const juce::String& variant,
+	double sampleRate, int blockSize, const ProcessorCallback& configure, const ProcessorCallback& beforeEachBlock = {})
+{
+	SimpleEQAudioProcessor processor;
+	useAllBands(processor);
+	if (configure)
+		configure(processor);
+	prepare(processor, sampleRate, blockSize);
+
+	//every block starts from the same noise, processing in place would let the boosts feed back into inf/NaN
+	juce::AudioBuffer<float> noise(2, blockSize);
+	fillWithNoise(noise);
+	juce::AudioBuffer<float> buffer(2, blockSize);
+	juce::MidiBuffer midi;
+
+	runner.run(name, variant, 1.f, [&]()
+	{
+		if (beforeEachBlock)
+			beforeEachBlock(processor);
+		buffer.makeCopyOf(noise, true);
+		processor.processBlock(buffer, midi);
+	});
+}
+
+static juce::String getSlopeName(Slope slope)
+{
+	return juce::String(12 + (int)slope * 12) + "dB";
+}
+
+//==============================================================================
+static void benchmarkProcessBlock(BenchmarkRunner& runner)
+{
+	for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+	{
+		for (auto blockSize : { 32, 64, 128, 256, 512, 1024, 2048 })
+		{
+			benchmarkProcessBlockVariant(runner, "processBlock", juce::String((int)sampleRate) + "Hz/" + juce::String(blockSize),
+				sampleRate, blockSize, {});
+		}
+	}
+}
+
+static void benchmarkSmoothing(BenchmarkRunner& runner)
+{
+	const juce::StringArray strides{ "off", "16", "32", "64" };
+
+	for (int choice = 0; choice < strides.size(); ++choice)
+	{
+		//automate the peak and both cut frequencies every block, so there is always a ramp in flight
+		bool flip = false;
+
+		benchmarkProcessBlockVariant(runner, "processBlock automated", "48000Hz/512/smoothing " + strides[choice], 48000.0, 512,
+			[choice](SimpleEQAudioProcessor& processor) { setParameter(processor, SimpleEQAudioProcessor::paramSmoothing, (float)choice); },
+			[&flip](SimpleEQAudioProcessor& processor)
+			{
+				flip = !flip;
+				processor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramPeakFreq)->store(flip ? 500.f : 5000.f);
+				processor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramLowCutFreq)->store(flip ? 40.f : 200.f);
+				processor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramHighCutFreq)->store(flip ? 8000.f : 16000.f);
+			});
+	}
+}
+
+static void benchmarkOversampling(BenchmarkRunner& runner)
+{
+	const juce::StringArray factors{ "off", "2x", "4x" };
+
+	for (auto sampleRate : { 44100.0, 48000.0 })
+	{
+		for (int choice = 0; choice < factors.size(); ++choice)
+		{
+			benchmarkProcessBlockVariant(runner, "processBlock oversampled", juce::String((int)sampleRate) + "Hz/512/" + factors[choice],
+				sampleRate, 512,
+				[choice](SimpleEQAudioProcessor& processor) { setParameter(processor, SimpleEQAudioProcessor::paramOversampling, (float)choice); });
+		}
+	}
+}
+
+static void benchmarkLinearPhase(BenchmarkRunner& runner)
+{
+	const juce::StringArray lengths{ "512", "1024", "2048", "4096", "8192" };
+
+	//the settings every kernel below is designed from
+	SimpleEQAudioProcessor settingsSource;
+	useAllBands(settingsSource);
+	auto chainSettings = getChainSettings(settingsSource.apvts);
+
+	for (int choice = 0; choice < lengths.size(); ++choice)
+	{
+		benchmarkProcessBlockVariant(runner, "processBlock linear phase", "48000Hz/512/" + lengths[choice] + " taps", 48000.0, 512,
+			[choice](SimpleEQAudioProcessor& processor)
+			{
+				setParameter(processor, SimpleEQAudioProcessor::paramProcessingMode, 1.f);
+				setParameter(processor, SimpleEQAudioProcessor::paramLinearPhaseLength, (float)choice);
+			});
+
+		//the background redesign, once per settings change
+		juce::AudioBuffer<float> kernel;
+
+		runner.run("LinearPhaseChain::designKernel", lengths[choice] + " taps", 1.f,
+			[&]() { LinearPhaseChain::designKernel(chainSettings, 48000.0, 512 << choice, kernel); });
+	}
+}
+
+static void benchmarkUpdateFilters(BenchmarkRunner& runner)
+{
+	SimpleEQAudioProcessor processor;
+	useAllBands(processor);
+	prepare(processor, 48000.0, 512);
+
+	auto settings = getChainSettings(processor.apvts);
+
+	runner.run("updateFilters", "all bands", 4.f, [&]() { processor.updateFilters(settings, true); });
+	runner.run("updateFilters", "unchanged", 4.f, [&]() { processor.updateFilters(settings); });
+}
+
+static void benchmarkUpdateCutFilter(BenchmarkRunner& runner)
+{
+	for (auto slope : { Slope::Slope_12, Slope::Slope_24, Slope::Slope_36, Slope::Slope_48 })
+	{
+		ChainSettings settings;
+		settings.lowCutFreq = 80.f;
+		settings.lowCutSlope = slope;
+
+		MonoChain chain;
+		prepareCoefficientStorage(chain);
+		auto& lowCut = chain.get<ChainPositions::LowCut>();
+
+		CutCoefficients coefficients;
+
+		runner.run("updateCutFilter", "designLowCutFilter/" + getSlopeName(slope), 4.f, [&]()
+		{
+			designLowCutFilter(settings, 48000.0, coefficients);
+			updateCutFilter(lowCut, coefficients, slope);
+		});
+
+		runner.run("updateCutFilter", "makeLowCutFilter/" + getSlopeName(slope), 4.f, [&]()
+		{
+			auto cutCoefficients = makeLowCutFilter(settings, 48000.0);
+			updateCutFilter(lowCut, cutCoefficients, slope);
+		});
+	}
+}
+
+static void benchmarkAnalyzer(BenchmarkRunner& runner)
+{
+	const auto fftBounds = juce::Rectangle<float>(0.f, 0.f, 560.f, 90.f);
+
+	for (auto order : { FFTOrder::order2048, FFTOrder::order4096, FFTOrder::order8192 })
+	{
+		FFTDataGenerator<std::vector<float>> generator;
+		generator.changeOrder(order);
+
+		const auto fftSize = generator.getFFTSize();
+
+		juce::AudioBuffer<float> monoBuffer(1, fftSize);
+		fillWithNoise(monoBuffer);
+
+		std::vector<float> fftData;
+
+		runner.run("produceFFTDataForRendering", juce::String(fftSize), 1.f, [&]()
+		{
+			generator.produceFFTDataForRendering(monoBuffer, -48.f);
+
+			while (generator.getNumAvailableFFTDataBlocks() > 0)
+				generator.getFFTData(fftData);
+		});
+
+		AnalyzerPathGenerator<juce::Path> pathGenerator;
+
+		runner.run("generatePath", juce::String(fftSize), 1.f, [&]()
+		{
+			pathGenerator.generatePath(fftData, fftBounds, fftSize, 48000.f / (float)fftSize, -48.f);
+			pathGenerator.acquireLatestPath();
+		});
+	}
+}
+
+//compare with produceFFTDataForRendering: averaging should cost far less than going up an FFT order
+static void benchmarkAnalyzerAveraging(BenchmarkRunner& runner)
+{
+	const auto numBins = (1 << FFTOrder::order8192) / 2;
+
+	std::vector<float> frame((size_t)numBins);
+	juce::Random random(0x5eed);
+
+	const std::pair<AnalyzerAveraging, juce::String> modes[] = {
+		{ AnalyzerAveraging::Exponential, "exponential" },
+		{ AnalyzerAveraging::MovingAverage, "moving average 32" },
+		{ AnalyzerAveraging::PeakHold, "peak hold" } };
+
+	for (auto& [mode, name] : modes)
+	{
+		AnalyzerAverager averager(numBins);
+
+		runner.run("AnalyzerAverager::process", name + "/" + juce::String(numBins * 2), 1.f, [&]()
+		{
+			for (auto& v : frame)
+				v = random.nextFloat() * -48.f;
+
+			averager.process(frame.data(), numBins, mode, AnalyzerAverager::maxNumFrames, 0.2f);
+		});
+	}
+}
+
+//the two loops produceFFTDataForRendering used before magnitudesToDecibels()
+static void referenceMagnitudesToDecibels(float* data, int numBins, float negativeInfinity)
+{
+	for (int i = 0; i < numBins; ++i)
+	{
+		auto v = data[i];
+		data[i] = (!std::isinf(v) && !std::isnan(v)) ? v / float(numBins) : 0.f;
+	}
+
+	for (int i = 0; i < numBins; ++i)
+		data[i] = juce::Decibels::gainToDecibels(data[i], negativeInfinity);
+}
+
+/*
+ returns the largest difference from the reference, in dB.
+ */
+static float benchmarkDecibelConversion(BenchmarkRunner& runner)
+{
+	const auto numBins = (1 << FFTOrder::order8192) / 2;
+	const auto negativeInfinity = -48.f;
+
+	//magnitudes spread over the whole displayed range and beyond, plus the values that need sanitizing
+	std::vector<float> magnitudes((size_t)numBins);
+	juce::Random random(0x5eed);
+	for (auto& m : magnitudes)
+		m = (float)numBins * juce::Decibels::decibelsToGain(random.nextFloat() * 120.f - 100.f);
+
+	magnitudes[0] = 0.f;
+	magnitudes[1] = std::numeric_limits<float>::infinity();
+	magnitudes[2] = std::numeric_limits<float>::quiet_NaN();
+
+	auto reference = magnitudes, fused = magnitudes;
+	referenceMagnitudesToDecibels(reference.data(), numBins, negativeInfinity);
+	magnitudesToDecibels(fused.data(), numBins, negativeInfinity);
+
+	auto maxError = 0.f;
+	for (int i = 0; i < numBins; ++i)
+		maxError = juce::jmax(maxError, std::abs(fused[(size_t)i] - reference[(size_t)i]));
+
+	std::vector<float> data((size_t)numBins);
+
+	runner.run("magnitudesToDecibels", "reference/" + juce::String(numBins * 2), 1.f, [&]()
+	{
+		std::copy(magnitudes.begin(), magnitudes.end(), data.begin());
+		referenceMagnitudesToDecibels(data.data(), numBins, negativeInfinity);
+	});
+
+	runner.run("magnitudesToDecibels", "fused/" + juce::String(numBins * 2), 1.f, [&]()
+	{
+		std::copy(magnitudes.begin(), magnitudes.end(), data.begin());
+		magnitudesToDecibels(data.data(), numBins, negativeInfinity);
+	});
+
+	std::cerr << "magnitudesToDecibels max error: " << maxError << " dB" << std::endl;
+	return maxError;
+}
+
+//|H(jw)|^2 of the analog peak both designs start from, see designPeakFilter
+static double getAnalogPeakMagnitudeSquared(const ChainSettings& chainSettings, double frequency)
+{
+	const auto A = std::sqrt((double)juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+	const auto x = frequency / chainSettings.peakFreq;
+	const auto real = 1.0 - x * x;
+	const auto numeratorImag = x * A / chainSettings.peakQuality;
+	const auto denominatorImag = x / (A * chainSettings.peakQuality);
+
+	return (real * real + numeratorImag * numeratorImag) / (real * real + denominatorImag * denominatorImag);
+}
+
+//worst deviation from the analog prototype between 20 Hz and 20 kHz, in dB
+static double getPeakDesignError(const ChainSettings& chainSettings, const FrequencyResponseGrid& grid)
+{
+	BiquadCoefficients coefficients;
+	designPeakFilter(chainSettings, grid.getSampleRate(), coefficients);
+
+	std::vector<double> magnitudeSquared((size_t)grid.getNumPoints(), 1.0);
+	multiplyByMagnitudeSquared(grid, coefficients, magnitudeSquared.data());
+
+	auto maxError = 0.0;
+	for (size_t i = 0; i < magnitudeSquared.size(); ++i)
+	{
+		auto analog = getAnalogPeakMagnitudeSquared(chainSettings, grid.frequencies[i]);
+		maxError = juce::jmax(maxError, std::abs(10.0 * std::log10(magnitudeSquared[i] / analog)));
+	}
+
+	return maxError;
+}
+
+//returns true if the matched design beats the bilinear one wherever the bilinear one is off by more than 0.1 dB
+static bool benchmarkPeakDesign(BenchmarkRunner& runner)
+{
+	const juce::StringArray designs{ "bilinear", "matched" };
+	auto matchedIsBetter = true;
+
+	FrequencyResponseGrid grid;
+	grid.prepare(1024, 20.0, 20000.0, 44100.0);
+
+	for (auto freq : { 1000.f, 5000.f, 10000.f, 15000.f, 18000.f })
+	{
+		for (auto quality : { 0.5f, 1.f, 4.f })
+		{
+			for (auto gain : { -12.f, 12.f })
+			{
+				ChainSettings chainSettings;
+				chainSettings.peakFreq = freq;
+				chainSettings.peakQuality = quality;
+				chainSettings.peakGainInDecibels = gain;
+
+				chainSettings.peakDesign = PeakDesign::PeakDesign_Bilinear;
+				auto bilinearError = getPeakDesignError(chainSettings, grid);
+
+				chainSettings.peakDesign = PeakDesign::PeakDesign_Matched;
+				auto matchedError = getPeakDesignError(chainSettings, grid);
+
+				if (bilinearError > 0.1 && matchedError >= bilinearError)
+					matchedIsBetter = false;
+
+				std::cerr << "peak " << freq << "Hz Q" << quality << " " << gain << "dB at 44100Hz, max error: bilinear "
+					<< bilinearError << " dB, matched " << matchedError << " dB" << std::endl;
+			}
+		}
+	}
+
+	for (int design = 0; design < designs.size(); ++design)
+	{
+		ChainSettings chainSettings;
+		chainSettings.peakFreq = 15000.f;
+		chainSettings.peakGainInDecibels = 6.f;
+		chainSettings.peakDesign = (PeakDesign)design;
+		BiquadCoefficients coefficients;
+
+		runner.run("designPeakFilter", designs[design], 10.f,
+			[&]() { designPeakFilter(chainSettings, 44100.0, coefficients); });
+
+		//the per sample cost is the same biquad either way
+		benchmarkProcessBlockVariant(runner, "processBlock peak design", "44100Hz/512/" + designs[design], 44100.0, 512,
+			[design](SimpleEQAudioProcessor& processor) { setParameter(processor, SimpleEQAudioProcessor::paramPeakDesign, (float)design); });
+	}
+
+	return matchedIsBetter;
+}
+
+static void benchmarkResponseMagnitudes(BenchmarkRunner& runner)
+{
+	SimpleEQAudioProcessor processor;
+	useAllBands(processor);
+
+	//the nine biquads the editor's curve goes through
+	auto settings = getChainSettings(processor.apvts);
+	MonoChain chain;
+	prepareCoefficientStorage(chain);
+
+	CutCoefficients lowCut, highCut;
+	BiquadCoefficients peak;
+	designLowCutFilter(settings, 48000.0, lowCut);
+	designHighCutFilter(settings, 48000.0, highCut);
+	designPeakFilter(settings, 48000.0, peak);
+
+	updateCutFilter(chain.get<ChainPositions::LowCut>(), lowCut, settings.lowCutSlope);
+	updateCutFilter(chain.get<ChainPositions::HighCut>(), highCut, settings.highCutSlope);
+	updateCoefficients(chain.get<ChainPositions::Peak>().coefficients, peak);
+
+	const int numPoints = 600;
+	std::vector<double> magnitudes((size_t)numPoints);
+
+	runner.run("response magnitudes", "getMagnitudeForFrequency/600", 1.f, [&]()
+	{
+		auto addCut = [&](const CutFilter& cut, double freq, double& mag)
+		{
+			mag *= cut.get<0>().coefficients->getMagnitudeForFrequency(freq, 48000.0);
+			mag *= cut.get<1>().coefficients->getMagnitudeForFrequency(freq, 48000.0);
+			mag *= cut.get<2>().coefficients->getMagnitudeForFrequency(freq, 48000.0);
+			mag *= cut.get<3>().coefficients->getMagnitudeForFrequency(freq, 48000.0);
+		};
+
+		for (int i = 0; i < numPoints; ++i)
+		{
+			auto freq = juce::mapToLog10(double(i) / double(numPoints), 20.0, 20000.0);
+			double mag = chain.get<ChainPositions::Peak>().coefficients->getMagnitudeForFrequency(freq, 48000.0);
+			addCut(chain.get<ChainPositions::LowCut>(), freq, mag);
+			addCut(chain.get<ChainPositions::HighCut>(), freq, mag);
+			magnitudes[(size_t)i] = mag;
+		}
+	});
+
+	FrequencyResponseGrid grid;
+	grid.prepare(numPoints, 20.0, 20000.0, 48000.0);
+
+	runner.run("response magnitudes", "getChainMagnitudeSquared/600", 1.f, [&]()
+	{
+		getChainMagnitudeSquared(chain, grid, magnitudes.data());
+	});
+
+	//per band complex responses and group delay, what the editor's overlays come from
+	ChainResponse response;
+
+	runner.run("response magnitudes", "getChainResponse/600", 1.f, [&]()
+	{
+		getChainResponse(chain, grid, response);
+	});
+}
+
+static void benchmarkResponseCurve(BenchmarkRunner& runner)
+{
+	SimpleEQAudioProcessor processor;
+	useAllBands(processor);
+	prepare(processor, 48000.0, 512);
+
+	ResponseCurveComponent responseCurve(processor);
+	responseCurve.setSize(600, 112);
+
+	/*
+	 the background used to be built once at logical size and resampled to the screen on every paint.
+	 now it is built at the physical scale and blitted 1:1. the logical build doesn't depend on the scale,
+	 so it is timed once.
+	 */
+	runner.run("background rebuild", "logical", 0.1f, [&]() { responseCurve.updateBackground(1.f); });
+	auto logical = responseCurve.getBackground(); //updateBackground makes a new image, so this one stays as it is
+
+	for (auto scale : { 1, 2, 3 })
+	{
+		const auto scaleName = juce::String(scale) + "x";
+		const auto transform = juce::AffineTransform::scale((float)scale);
+
+		//a target the size of the physical pixels, like a HiDPI window
+		juce::Image target(juce::Image::RGB, responseCurve.getWidth() * scale, responseCurve.getHeight() * scale, true);
+		juce::Graphics g(target);
+		g.addTransform(transform);
+
+		runner.run("ResponseCurveComponent::paint", "600x112/" + scaleName, 0.25f, [&]() { responseCurve.paint(g); });
+
+		runner.run("background rebuild", "physical/" + scaleName, 0.1f, [&]() { responseCurve.updateBackground((float)scale); });
+		auto physical = responseCurve.getBackground();
+
+		runner.run("background blit", "resampled/" + scaleName, 0.25f, [&]()
+		{
+			g.drawImage(logical, juce::Rectangle<float>(0.f, 0.f, (float)responseCurve.getWidth(), (float)responseCurve.getHeight()));
+		});
+
+		runner.run("background blit", "1:1/" + scaleName, 0.25f, [&]()
+		{
+			g.drawImageTransformed(physical, juce::AffineTransform::scale(1.f / (float)scale));
+		});
+	}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+	juce::ArgumentList args(argc, argv);
+
+	auto iterations = 2000;
+	if (args.containsOption("--iterations"))
+		iterations = juce::jmax(10, args.getValueForOption("--iterations").getIntValue());
+
+	BenchmarkRunner runner(iterations);
+
+	benchmarkProcessBlock(runner);
+	benchmarkSmoothing(runner);
+	benchmarkOversampling(runner);
+	benchmarkLinearPhase(runner);
+	benchmarkUpdateFilters(runner);
+	benchmarkUpdateCutFilter(runner);
+	benchmarkAnalyzer(runner);
+	benchmarkAnalyzerAveraging(runner);
+	auto decibelError = benchmarkDecibelConversion(runner);
+	auto matchedPeakIsBetter = benchmarkPeakDesign(runner);
+	benchmarkResponseMagnitudes(runner);
+	benchmarkResponseCurve(runner);
+
+	auto output = args.containsOption("--json") ? runner.toJSON() : runner.toCSV();
+
+	if (args.containsOption("--output"))
+	{
+		auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+		if (!file.replaceWithText(output))
+		{
+			std::cerr << "can't write " << file.getFullPathName() << std::endl;
+			return 1;
+		}
+	}
+	else
+	{
+		std::cout << output << std::endl;
+	}
+
+	//the fast log must stay well below anything visible on the analyzer
+	if (decibelError > 0.01f)
+	{
+		std::cerr << "magnitudesToDecibels is off by more than 0.01 dB" << std::endl;
+		return 1;
+	}
+
+	if (!matchedPeakIsBetter)
+	{
+		std::cerr << "the matched peak design is no closer to the analog prototype than the bilinear one" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+	Offline renderer: streams audio files through SimpleEQAudioProcessor
+	without an editor or a host.
+
+	SimpleEQRender --state=<file> [--output=<dir>] [--block-size=<n>] [--threads=<n>] <files...>
+
+	--state      a blob written by SimpleEQAudioProcessor::getStateInformation
+	--output     where to write the results (defaults to next to each input)
+	--block-size samples per processBlock call (default 8192)
+	--threads    number of files rendered in parallel (default: number of cores)
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+#include <atomic>
+#include <iostream>
+
+struct RenderSettings
+{
+	juce::MemoryBlock state;
+	juce::File outputDirectory;
+	int blockSize = 8192;
+};
+
+struct RenderJob : public juce::ThreadPoolJob
+{
+	RenderJob(const juce::File& input, const RenderSettings& renderSettings,
+		juce::CriticalSection& reportLock, std::atomic<int>& failureCount) :
+		juce::ThreadPoolJob(input.getFileName()),
+		inputFile(input),
+		settings(renderSettings),
+		lock(reportLock),
+		failures(failureCount)
+	{
+	}
+
+	JobStatus runJob() override
+	{
+		juce::String error;
+
+		if (!render(error))
+		{
+			++failures;
+			report(inputFile.getFileName() + ": " + error, std::cerr);
+		}
+
+		return jobHasFinished;
+	}
+private:
+	juce::File inputFile;
+	const RenderSettings& settings;
+	juce::CriticalSection& lock;
+	std::atomic<int>& failures;
+
+	bool render(juce::String& error)
+	{
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
+
+		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+		if (reader == nullptr)
+		{
+			error = "unsupported or unreadable file";
+			return false;
+		}
+
+		const auto numChannels = (int)reader->numChannels;
+		const auto sampleRate = reader->sampleRate;
+		const auto totalLength = reader->lengthInSamples;
+
+		SimpleEQAudioProcessor processor;
+
+		auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+		if (channelSet.size() != numChannels)
+			channelSet = juce::AudioChannelSet::discreteChannels(numChannels);
+
+		juce::AudioProcessor::BusesLayout layout;
+		layout.inputBuses.add(channelSet);
+		layout.outputBuses.add(channelSet);
+
+		if (!processor.setBusesLayout(layout))
+		{
+			error = "unsupported channel layout (" + juce::String(numChannels) + " channels)";
+			return false;
+		}
+
+		processor.setStateInformation(settings.state.getData(), (int)settings.state.getSize());
+		processor.setNonRealtime(true);
+		processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+		processor.prepareToPlay(sampleRate, settings.blockSize);
+
+		auto outputDirectory = settings.outputDirectory == juce::File() ? inputFile.getParentDirectory()
+			: settings.outputDirectory;
+		auto outputFile = outputDirectory.getChildFile(inputFile.getFileNameWithoutExtension()
+			+ "_SimpleEQ" + inputFile.getFileExtension());
+
+		auto* format = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+		if (format == nullptr)
+		{
+			error = "no writer for " + outputFile.getFileExtension();
+			return false;
+		}
+
+		outputFile.deleteFile();
+		auto outputStream = outputFile.createOutputStream();
+
+		std::unique_ptr<juce::AudioFormatWriter> writer;
+		if (outputStream != nullptr)
+			writer.reset(format->createWriterFor(outputStream.get(), sampleRate, (unsigned int)numChannels,
+				(int)reader->bitsPerSample, reader->metadataValues, 0));
+
+		if (writer == nullptr)
+		{
+			error = "can't write " + outputFile.getFullPathName();
+			return false;
+		}
+
+		outputStream.release(); //the writer owns it now
+
+		juce::AudioBuffer<float> buffer(numChannels, settings.blockSize);
+		juce::MidiBuffer midi;
+
+		//reads past the end of the file are zero filled, which flushes the latency out
+		const auto latency = (juce::int64)processor.getLatencySamples();
+		juce::int64 readPosition = 0, samplesWritten = 0;
+
+		auto startTicks = juce::Time::getHighResolutionTicks();
+
+		while (samplesWritten < totalLength)
+		{
+			reader->read(buffer.getArrayOfWritePointers(), numChannels, readPosition, settings.blockSize);
+			processor.processBlock(buffer, midi);
+
+			//drop the first 'latency' samples so the output lines up with the input
+			auto numToSkip = (int)juce::jlimit<juce::int64>(0, settings.blockSize, latency - readPosition);
+			auto numToWrite = (int)juce::jmin<juce::int64>(settings.blockSize - numToSkip, totalLength - samplesWritten);
+
+			readPosition += settings.blockSize;
+
+			if (numToWrite > 0)
+			{
+				writer->writeFromAudioSampleBuffer(buffer, numToSkip, numToWrite);
+				samplesWritten += numToWrite;
+			}
+		}
+
+		auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+		auto audioSeconds = (double)totalLength / sampleRate;
+
+		processor.releaseResources();
+
+		juce::String message;
+		message << inputFile.getFileName() << " -> " << outputFile.getFileName() << ": "
+			<< juce::String(audioSeconds, 2) << " s of audio in " << juce::String(elapsedSeconds, 3) << " s"
+			<< " (" << juce::String(audioSeconds / juce::jmax(elapsedSeconds, 1.0e-9), 1) << "x real time)";
+
+		report(message, std::cout);
+		return true;
+	}
+
+	void report(const juce::String& message, std::ostream& stream)
+	{
+		const juce::ScopedLock sl(lock);
+		stream << message << std::endl;
+	}
+};
+
+static void printUsage()
+{
+	std::cout << "usage: SimpleEQRender --state=<file> [--output=<dir>] [--block-size=<n>] [--threads=<n>] <files...>" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+	juce::ArgumentList args(argc, argv);
+
+	if (args.containsOption("--help|-h"))
+	{
+		printUsage();
+		return 0;
+	}
+
+	RenderSettings settings;
+
+	auto stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--state"));
+	if (!args.containsOption("--state") || !stateFile.loadFileAsData(settings.state))
+	{
+		std::cerr << "can't read the state file" << std::endl;
+		printUsage();
+		return 1;
+	}
+
+	if (args.containsOption("--output"))
+	{
+		settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+		settings.outputDirectory.createDirectory();
+	}
+
+	if (args.containsOption("--block-size"))
+		settings.blockSize = juce::jmax(32, args.getValueForOption("--block-size").getIntValue());
+
+	auto numThreads = juce::SystemStats::getNumCpus();
+	if (args.containsOption("--threads"))
+		numThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+
+	juce::Array<juce::File> inputFiles;
+	for (auto& arg : args.arguments)
+	{
+		if (!arg.isOption())
+			inputFiles.add(arg.resolveAsFile());
+	}
+
+	if (inputFiles.isEmpty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	juce::CriticalSection reportLock;
+	std::atomic<int> failures{ 0 };
+
+	{
+		juce::ThreadPool pool(juce::jmin(numThreads, inputFiles.size()));
+
+		for (auto& file : inputFiles)
+			pool.addJob(new RenderJob(file, settings, reportLock, failures), true);
+
+		while (pool.getNumJobs() > 0)
+			juce::Thread::sleep(10);
+	}
+
+	return failures.load() == 0 ? 0 : 1;
+}
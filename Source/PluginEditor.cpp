@@ -24,48 +24,57 @@ void LookAndFeel::drawRotarySlider(juce::Graphics& g,
 	auto bounds = juce::Rectangle<float>(x, y, width, height);
 	auto enabled = slider.isEnabled();
 
-	g.setColour(enabled ? Colour(97u, 18u, 167u): Colours::darkgrey);
-	g.fillEllipse(bounds);
-
-	g.setColour(enabled ? Colour(255u, 154u, 1u) : Colours::grey);
-	g.drawEllipse(bounds, 1.f);
+	drawRotarySliderBody(g, bounds, enabled);
 
 	if (auto* rswl = dynamic_cast<RotarySliderWithLabels*>(&slider))
 	{
-		auto center = bounds.getCentre();
+		jassert(rotaryStartAngle < endAngle);
 
-		Path p;
+		auto sliderAngRad = jmap(sliderPosPrportional, 0.0f, 1.f, rotaryStartAngle, endAngle);
+		auto pointer = RotarySliderWithLabels::makePointerPath(bounds, rswl->getTextHeight());
 
-		Rectangle<float>r;
-		r.setLeft(center.getX() - 2);
-		r.setRight(center.getX() + 2);
-		r.setTop(bounds.getY());
-		r.setBottom(center.getY() - rswl->getTextHeight() * 1.5);
+		drawRotarySliderPointer(g, bounds, pointer, sliderAngRad, enabled, *rswl);
+	}
+}
 
+void LookAndFeel::drawRotarySliderBody(juce::Graphics& g, juce::Rectangle<float> bounds, bool enabled)
+{
+	using namespace juce;
 
-		p.addRoundedRectangle(r, 2.f);
+	g.setColour(enabled ? Colour(97u, 18u, 167u): Colours::darkgrey);
+	g.fillEllipse(bounds);
 
-		jassert(rotaryStartAngle < endAngle);
+	g.setColour(enabled ? Colour(255u, 154u, 1u) : Colours::grey);
+	g.drawEllipse(bounds, 1.f);
+}
 
-		auto sliderAngRad = jmap(sliderPosPrportional, 0.0f, 1.f, rotaryStartAngle, endAngle);
-		p.applyTransform(AffineTransform().rotated(sliderAngRad, center.getX(), center.getY()));
+void LookAndFeel::drawRotarySliderPointer(juce::Graphics& g,
+	juce::Rectangle<float> bounds,
+	const juce::Path& pointer,
+	float angle,
+	bool enabled,
+	const RotarySliderWithLabels& rswl)
+{
+	using namespace juce;
 
+	auto center = bounds.getCentre();
 
-		g.fillPath(p);
+	g.setColour(enabled ? Colour(255u, 154u, 1u) : Colours::grey);
+	g.fillPath(pointer, AffineTransform().rotated(angle, center.getX(), center.getY()));
 
-		g.setFont(rswl->getTextHeight());
-		auto text = rswl->getDisplayString();
-		auto strWidth = g.getCurrentFont().getStringWidth(text);
+	g.setFont(rswl.getTextHeight());
+	const auto& text = rswl.getCachedDisplayString();
+	auto strWidth = g.getCurrentFont().getStringWidth(text);
 
-		r.setSize(strWidth + 4, rswl->getTextHeight() + 2);
-		r.setCentre(bounds.getCentre());
+	Rectangle<float> r;
+	r.setSize(strWidth + 4, rswl.getTextHeight() + 2);
+	r.setCentre(bounds.getCentre());
 
-		g.setColour(Colours::black);
-		g.fillRect(r);
+	g.setColour(Colours::black);
+	g.fillRect(r);
 
-		g.setColour(Colours::white);
-		g.drawFittedText(text, r.toNearestInt(), juce::Justification::centred, 1);
-	}
+	g.setColour(Colours::white);
+	g.drawFittedText(text, r.toNearestInt(), juce::Justification::centred, 1);
 }
 
 void LookAndFeel::drawToggleButton(juce::Graphics& g,
@@ -128,47 +137,89 @@ void RotarySliderWithLabels::paint(juce::Graphics& g)
 	auto startAng = degreesToRadians(180.f + 45.f);
 	auto endAng = degreesToRadians(180.f - 45.f) + MathConstants<float>::twoPi;
 
+	auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	if (!staticLayer.isValid() || scale != staticLayerScale)
+		updateStaticLayer(scale);
+
+	g.drawImage(staticLayer, getLocalBounds().toFloat());
+
 	auto range = getRange();
+	auto sliderPos = (float)jmap(getValue(), range.getStart(), range.getEnd(), 0.0, 1.0);
+
+	lnf.drawRotarySliderPointer(g,
+		getSliderBounds().toFloat(),
+		pointerPath,
+		jmap(sliderPos, 0.f, 1.f, startAng, endAng),
+		isEnabled(),
+		*this);
+}
+
+juce::Path RotarySliderWithLabels::makePointerPath(juce::Rectangle<float> sliderBounds, int textHeight)
+{
+	auto center = sliderBounds.getCentre();
+
+	juce::Rectangle<float> r;
+	r.setLeft(center.getX() - 2);
+	r.setRight(center.getX() + 2);
+	r.setTop(sliderBounds.getY());
+	r.setBottom(center.getY() - textHeight * 1.5);
+
+	juce::Path p;
+	p.addRoundedRectangle(r, 2.f);
+	return p;
+}
+
+void RotarySliderWithLabels::updateStaticLayer(float scale)
+{
+	using namespace juce;
+
+	staticLayerScale = scale;
+
 	auto sliderBounds = getSliderBounds();
+	pointerPath = makePointerPath(sliderBounds.toFloat(), getTextHeight());
 
+	if (getWidth() <= 0 || getHeight() <= 0)
+	{
+		staticLayer = Image();
+		return;
+	}
 
-		getLookAndFeel().drawRotarySlider(
-			g,
-			sliderBounds.getX(),
-			sliderBounds.getY(),
-			sliderBounds.getWidth(),
-			sliderBounds.getHeight(),
-			jmap(getValue(), range.getStart(), range.getEnd(), 0.0, 1.0),
-			startAng,
-			endAng,
-			*this);
+	staticLayer = Image(Image::ARGB, jmax(1, roundToInt(getWidth() * scale)), jmax(1, roundToInt(getHeight() * scale)), true);
 
-		auto center = sliderBounds.toFloat().getCentre();
-		auto radius = sliderBounds.getWidth() * 0.5f;
+	Graphics g(staticLayer);
+	g.addTransform(AffineTransform::scale(scale));
 
-		g.setColour(Colour(0u, 172u, 1u));
-		g.setFont(getTextHeight());
+	auto startAng = degreesToRadians(180.f + 45.f);
+	auto endAng = degreesToRadians(180.f - 45.f) + MathConstants<float>::twoPi;
 
-		auto numChoices = labels.size();
-		for (int i = 0; i < numChoices; i++)
-		{
-			auto pos = labels[i].pos;
-			jassert(0.f <= pos);
-			jassert(pos <= 1.f);
+	lnf.drawRotarySliderBody(g, sliderBounds.toFloat(), isEnabled());
 
-			auto ang = jmap(pos, 0.f, 1.f, startAng, endAng);
+	auto center = sliderBounds.toFloat().getCentre();
+	auto radius = sliderBounds.getWidth() * 0.5f;
 
-			auto c = center.getPointOnCircumference(radius + getTextHeight() * 0.5f + 1, ang);
+	g.setColour(Colour(0u, 172u, 1u));
+	g.setFont(getTextHeight());
 
-			Rectangle<float> r;
-			auto str = labels[i].label;
+	auto numChoices = labels.size();
+	for (int i = 0; i < numChoices; i++)
+	{
+		auto pos = labels[i].pos;
+		jassert(0.f <= pos);
+		jassert(pos <= 1.f);
 
-			r.setSize(g.getCurrentFont().getStringWidth(str), getTextHeight());
-			r.setCentre(c);
+		auto ang = jmap(pos, 0.f, 1.f, startAng, endAng);
 
-			r.setY(r.getY() + getTextHeight());
-			g.drawFittedText(str, r.toNearestInt(), juce::Justification::centred, 1);
-		}
+		auto c = center.getPointOnCircumference(radius + getTextHeight() * 0.5f + 1, ang);
+
+		Rectangle<float> r;
+		auto str = labels[i].label;
+
+		r.setSize(g.getCurrentFont().getStringWidth(str), getTextHeight());
+		r.setCentre(c);
+
+		r.setY(r.getY() + getTextHeight());
+		g.drawFittedText(str, r.toNearestInt(), juce::Justification::centred, 1);
+	}
 }
 
 juce::Rectangle<int> RotarySliderWithLabels::getSliderBounds() const
@@ -190,15 +241,16 @@ juce::Rectangle<int> RotarySliderWithLabels::getSliderBounds() const
 
 juce::String RotarySliderWithLabels::getDisplayString() const
 {
-	if (auto* choiceParam = dynamic_cast<juce::AudioParameterChoice*>(param))
+	//from the slider, valueChanged() runs before the attachment has passed the value on to the parameter
+	if (choiceParam != nullptr)
 	{
-		return choiceParam->getCurrentChoiceName();
+		return choiceParam->choices[juce::jlimit(0, choiceParam->choices.size() - 1, juce::roundToInt(getValue()))];
 	}
 
 	juce::String str;
 	bool addK = false;
 
-	if (auto* choiceParam = dynamic_cast<juce::AudioParameterFloat*>(param))
+	if (floatParam != nullptr)
 	{
 		float val = getValue();
 
@@ -230,6 +282,63 @@ juce::String RotarySliderWithLabels::getDisplayString() const
 
 	return str;
 }
+//=============================================================================
+void DspLoadMeterComponent::paint(juce::Graphics& g)
+{
+	using namespace juce;
+
+	auto bounds = getLocalBounds();
+	auto histogramArea = bounds.removeFromRight(DspLoadMeter::numBuckets * 2).toFloat();
+
+	auto overruns = loadMeter.getNumOverruns();
+
+	String str;
+	str << "DSP " << String(loadMeter.getLastLoad() * 100.f, 1) << "%"
+		<< "  p99 " << String(loadMeter.getPercentile(99.f) * 100.f, 0) << "%"
+		<< "  max " << String(loadMeter.getMaxLoad() * 100.f, 0) << "%"
+		<< "  over " << overruns;
+
+	auto textArea = bounds.reduced(2, 0);
+
+	if (analyzer != nullptr)
+	{
+		//FFTs that are overwritten before the editor picks them up are wasted analyzer work
+		auto numFFTs = analyzer->getNumFFTsComputed();
+		auto numFrames = analyzer->getNumFramesDisplayed();
+
+		String analyzerStr;
+		analyzerStr << "FFT " << numFFTs << "  shown " << numFrames;
+		if (numFFTs > 0)
+			analyzerStr << " (" << String(100.0 * double(numFrames) / double(numFFTs), 0) << "%)";
+
+		g.setColour(Colours::lightgrey);
+		g.setFont(10.f);
+		g.drawFittedText(analyzerStr, textArea.removeFromBottom(textArea.getHeight() / 2), Justification::centredRight, 1);
+	}
+
+	g.setColour(overruns > 0 ? Colours::orange : Colours::lightgrey);
+	g.setFont(analyzer != nullptr ? 10.f : 11.f);
+	g.drawFittedText(str, textArea, Justification::centredRight, 1);
+
+	//one bar per bucket, scaled to the fullest bucket
+	juce::int64 fullest = 1;
+	for (int bucket = 0; bucket < DspLoadMeter::numBuckets; ++bucket)
+		fullest = jmax(fullest, loadMeter.getBucketCount(bucket));
+
+	for (int bucket = 0; bucket < DspLoadMeter::numBuckets; ++bucket)
+	{
+		auto proportion = float(loadMeter.getBucketCount(bucket)) / float(fullest);
+		auto barHeight = histogramArea.getHeight() * proportion;
+		auto overBudget = (bucket + 1) * DspLoadMeter::bucketWidth > 1.f;
+
+		g.setColour(overBudget ? Colours::orange : Colour(0u, 172u, 1u));
+		g.fillRect(histogramArea.getX() + bucket * 2.f, histogramArea.getBottom() - barHeight, 2.f, barHeight);
+	}
+
+	g.setColour(Colours::dimgrey);
+	g.drawRect(histogramArea);
+}
+
 //=============================================================================
 ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor& p) :
 	audioProcessor(p),
@@ -242,12 +351,39 @@ ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor& p) :
 		param->addListener(this);
 	}
 
+	analyzerResolution = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramAnalyzerResolution);
+	analyzerOverlap = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramAnalyzerOverlap);
+	analyzerAveraging = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramAnalyzerAveraging);
+	analyzerAverageFrames = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramAnalyzerAverageFrames);
+	analyzerPeakDecay = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramAnalyzerPeakDecay);
+	analyzerView = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramAnalyzerView);
+	showBandCurves = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramShowBandCurves);
+	showPhase = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramShowPhase);
+	showGroupDelay = audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramShowGroupDelay);
+
+	//quiet to loud: black, blue, purple, red, orange, yellow, white
+	juce::ColourGradient gradient(juce::Colours::black, 0.f, 0.f, juce::Colours::white, 1.f, 0.f, false);
+	gradient.addColour(0.2, juce::Colours::darkblue);
+	gradient.addColour(0.4, juce::Colours::purple);
+	gradient.addColour(0.6, juce::Colours::red);
+	gradient.addColour(0.75, juce::Colours::orange);
+	gradient.addColour(0.9, juce::Colours::yellow);
+
+	for (size_t i = 0; i < spectrogramColours.size(); ++i)
+		spectrogramColours[i] = gradient.getColourAtPosition((double)i / (double)(spectrogramColours.size() - 1)).getPixelARGB();
+
+	spectrogramColumn.reserve(SpectrogramColumnGenerator::maxNumRows);
+
+	toggleAnalysisEnablement(audioProcessor.apvts.getRawParameterValue(SimpleEQAudioProcessor::paramAnalyzerEnabled)->load() > 0.5f);
+
 	updateChain();
-	startTimerHz(60);
+	setRefreshRate(60);
 }
 
 ResponseCurveComponent::~ResponseCurveComponent()
 {
+	toggleAnalysisEnablement(false);
+
 	const auto& params = audioProcessor.getParameters();
 	for (auto param : params)
 	{
@@ -255,19 +391,69 @@ ResponseCurveComponent::~ResponseCurveComponent()
 	}
 }
 
+void ResponseCurveComponent::toggleAnalysisEnablement(bool enabled)
+{
+	shouldShowFFTAnalysis = enabled;
+	updateAnalyzerAttachment();
+}
+
+void ResponseCurveComponent::updateAnalyzerAttachment()
+{
+	//isShowing() is also false while the window is minimised
+	auto shouldAttach = shouldShowFFTAnalysis && isShowing();
+
+	if (shouldAttach == analyzerAttached)
+		return;
+
+	//the processor only feeds the analyzer FIFOs while someone is reading them
+	if (shouldAttach)
+	{
+		auto fftBounds = getAnalysisArea().toFloat();
+		auto sampleRate = audioProcessor.getSampleRate();
+
+		leftPathProducer.setRenderParameters(fftBounds, sampleRate);
+		rightPathProducer.setRenderParameters(fftBounds, sampleRate);
+
+		audioProcessor.setAnalyzerConsumerAttached(true);
+		analyzerThread->addTimeSliceClient(&leftPathProducer);
+		analyzerThread->addTimeSliceClient(&rightPathProducer);
+	}
+	else
+	{
+		//waits for a time slice that is already running
+		analyzerThread->removeTimeSliceClient(&leftPathProducer);
+		analyzerThread->removeTimeSliceClient(&rightPathProducer);
+		audioProcessor.setAnalyzerConsumerAttached(false);
+	}
+
+	analyzerAttached = shouldAttach;
+}
+
+void ResponseCurveComponent::setRefreshRate(int newRateHz)
+{
+	if (newRateHz == refreshRateHz)
+		return;
+
+	refreshRateHz = newRateHz;
+	startTimerHz(refreshRateHz);
+}
+
 void ResponseCurveComponent::updateChain()
 {
 	auto chainSettings = getChainSettings(audioProcessor.apvts);
 
+	//designed where the processor runs them, so oversampling shows up in the curve
+	auto sampleRate = audioProcessor.getFilterSampleRate();
+
 	monoChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
 	monoChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
 	monoChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
 
-	auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
+	auto peakCoefficients = makePeakFilter(chainSettings, sampleRate);
 	updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
 
-	auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-	auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
+	auto lowCutCoefficients = makeLowCutFilter(chainSettings, sampleRate);
+	auto highCutCoefficients = makeHighCutFilter(chainSettings, sampleRate);
 
 	updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
 	updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
@@ -278,129 +464,200 @@ void ResponseCurveComponent::paint(juce::Graphics& g)
 	using namespace juce;
 	// (Our component is opaque, so we must completely fill the background with a solid colour)
 	g.fillAll(Colours::black);
-	g.drawImage(background, getLocalBounds().toFloat());
+
+	//rendered at the physical pixel scale, so this is a 1:1 blit instead of a resample on HiDPI screens
+	auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	if (!background.isValid() || scale != backgroundScale)
+		updateBackground(scale);
+
+	if (background.isValid())
+		g.drawImageTransformed(background, AffineTransform::scale(1.f / backgroundScale));
 
 	auto responseArea = getAnalysisArea();
 
-	auto w = responseArea.getWidth();
+	if (shouldShowFFTAnalysis && shouldShowSpectrogram && spectrogram.isValid())
+	{
+		//oldest columns on the left, newest on the right
+		auto height = spectrogram.getHeight();
+		auto olderWidth = spectrogram.getWidth() - spectrogramWriteX;
+
+		g.drawImage(spectrogram, responseArea.getX(), responseArea.getY(), olderWidth, height,
+			spectrogramWriteX, 0, olderWidth, height);
+		g.drawImage(spectrogram, responseArea.getX() + olderWidth, responseArea.getY(), spectrogramWriteX, height,
+			0, 0, spectrogramWriteX, height);
+	}
+	else if (shouldShowFFTAnalysis)
+	{
 
-	auto& lowCut = monoChain.get<ChainPositions::LowCut>();
-	auto& peak = monoChain.get<ChainPositions::Peak>();
-	auto& highCut = monoChain.get<ChainPositions::HighCut>();
+		auto translation = AffineTransform().translation(responseArea.getX(), responseArea.getY());
 
-	auto sampleRate = audioProcessor.getSampleRate();
+		g.setColour(Colours::skyblue);
+		g.strokePath(leftPathProducer.getPath(), PathStrokeType(1.f), translation);
 
-	std::vector<double> mags;
-	mags.resize(w);
+		g.setColour(Colours::yellow);
+		g.strokePath(rightPathProducer.getPath(), PathStrokeType(1.f), translation);
+	}
 
-	for (int i = 0; i < w; i++)
-	{
-		double mag = 1.f;
 
-		auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
 
-		if (!monoChain.isBypassed<ChainPositions::Peak>())
-		{
-			mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		}
+	g.setColour(Colours::orange);
+	g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
 
-		//LowCut
-		if (!monoChain.isBypassed<ChainPositions::LowCut>())
-		{
-			if (!lowCut.isBypassed<0>())
-			{
-				mag *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
+	//overlays are empty paths unless enabled, stroking them costs nothing then
+	g.setColour(Colours::lightblue.withAlpha(0.7f));
+	g.strokePath(bandCurves[ChainPositions::LowCut], PathStrokeType(1.f));
+	g.setColour(Colours::lightgreen.withAlpha(0.7f));
+	g.strokePath(bandCurves[ChainPositions::Peak], PathStrokeType(1.f));
+	g.setColour(Colours::pink.withAlpha(0.7f));
+	g.strokePath(bandCurves[ChainPositions::HighCut], PathStrokeType(1.f));
 
-			}
-			if (!lowCut.isBypassed<1>())
-			{
-				mag *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-			}
-			if (!lowCut.isBypassed<2>())
-			{
-				mag *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-			}
-			if (!lowCut.isBypassed<3>())
-			{
-				mag *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-			}
-		}
+	g.setColour(Colours::violet);
+	g.strokePath(phaseCurve, PathStrokeType(1.f));
+	g.setColour(Colours::cyan);
+	g.strokePath(groupDelayCurve, PathStrokeType(1.f));
 
+	g.setColour(Colours::white);
+	g.strokePath(responseCurve, PathStrokeType(2.f));
+}
 
-		//HighCut
-		if (!monoChain.isBypassed<ChainPositions::HighCut>())
-		{
-			if (!highCut.isBypassed<0>())
-			{
-				mag *= highCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
+void ResponseCurveComponent::updateResponseCurve()
+{
+	using namespace juce;
 
-			}
-			if (!highCut.isBypassed<1>())
-			{
-				mag *= highCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-			}
-			if (!highCut.isBypassed<2>())
-			{
-				mag *= highCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-			}
-			if (!highCut.isBypassed<3>())
-			{
-				mag *= highCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-			}
-		}
-		mags[i] = Decibels::gainToDecibels(mag);
-	}
+	auto responseArea = getAnalysisArea();
+	auto w = responseArea.getWidth();
+	auto sampleRate = audioProcessor.getFilterSampleRate();
+
+	responseCurve.clear();
+	phaseCurve.clear();
+	groupDelayCurve.clear();
+	for (auto& curve : bandCurves)
+		curve.clear();
 
-	Path responsiveCurve;
+	if (w <= 0 || sampleRate <= 0.0)
+		return;
+
+	if (responseGrid.getNumPoints() != w || responseGrid.getSampleRate() != sampleRate)
+		responseGrid.prepare(w, 20.0, 20000.0, sampleRate);
+
+	//everything below comes from this one pass over the biquads
+	getChainResponse(monoChain, responseGrid, chainResponse);
 
 	const double outputMin = responseArea.getBottom();
 	const double outputMax = responseArea.getY();
 
-	auto map = [outputMin, outputMax](double input)
+	auto map = [outputMin, outputMax](double magnitudeSquared)
 	{
+		//half the dB of the squared magnitude, floored at -100dB like before
+		auto input = Decibels::gainToDecibels(magnitudeSquared, -200.0) * 0.5;
 		return jmap(input, -24.0, 24.0, outputMin, outputMax);
 	};
 
-	responsiveCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+	auto buildMagnitudeCurve = [&](Path& curve, const ChainResponse::Complex& response)
+	{
+		curve.preallocateSpace(3 * (w + 1));
+		curve.startNewSubPath(responseArea.getX(), map(response.getMagnitudeSquared(0)));
+
+		for (size_t i = 0; i < (size_t)w; i++)
+		{
+			curve.lineTo(responseArea.getX() + i, map(response.getMagnitudeSquared(i)));
+		}
+	};
 
-	for (size_t i = 0; i < mags.size(); i++)
+	buildMagnitudeCurve(responseCurve, chainResponse.total);
+
+	if (showBandCurves->load() > 0.5f)
 	{
-		responsiveCurve.lineTo(responseArea.getX() + i, map(mags[i]));
+		if (!monoChain.isBypassed<ChainPositions::LowCut>())
+			buildMagnitudeCurve(bandCurves[ChainPositions::LowCut], chainResponse.bands[ChainPositions::LowCut]);
+		if (!monoChain.isBypassed<ChainPositions::Peak>())
+			buildMagnitudeCurve(bandCurves[ChainPositions::Peak], chainResponse.bands[ChainPositions::Peak]);
+		if (!monoChain.isBypassed<ChainPositions::HighCut>())
+			buildMagnitudeCurve(bandCurves[ChainPositions::HighCut], chainResponse.bands[ChainPositions::HighCut]);
 	}
 
-	if (shouldShowFFTAnalysis)
+	if (showPhase->load() > 0.5f)
 	{
+		//-180 to +180 degrees over the full height, a new sub path wherever the phase wraps
+		auto mapPhase = [outputMin, outputMax](double phase)
+		{
+			return jmap(phase, -MathConstants<double>::pi, MathConstants<double>::pi, outputMin, outputMax);
+		};
 
-		auto leftChannelFFTPath = leftPathProducer.getPath();
-		leftChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+		auto previous = chainResponse.total.getPhase(0);
+		phaseCurve.preallocateSpace(3 * (w + 1));
+		phaseCurve.startNewSubPath(responseArea.getX(), mapPhase(previous));
 
-		g.setColour(Colours::skyblue);
-		g.strokePath(leftChannelFFTPath, PathStrokeType(1.f));
+		for (size_t i = 1; i < (size_t)w; i++)
+		{
+			auto phase = chainResponse.total.getPhase(i);
+			auto x = responseArea.getX() + i;
 
+			if (std::abs(phase - previous) > MathConstants<double>::pi)
+				phaseCurve.startNewSubPath(x, mapPhase(phase));
+			else
+				phaseCurve.lineTo(x, mapPhase(phase));
 
-		auto rightChannelFFTPath = rightPathProducer.getPath();
-		rightChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+			previous = phase;
+		}
+	}
 
-		g.setColour(Colours::yellow);
-		g.strokePath(rightChannelFFTPath, PathStrokeType(1.f));
+	if (showGroupDelay->load() > 0.5f)
+	{
+		//0 to 10ms from the bottom up
+		auto mapDelay = [outputMin, outputMax, sampleRate](double samples)
+		{
+			auto ms = jlimit(0.0, 10.0, samples * 1000.0 / sampleRate);
+			return jmap(ms, 0.0, 10.0, outputMin, outputMax);
+		};
+
+		groupDelayCurve.preallocateSpace(3 * (w + 1));
+		groupDelayCurve.startNewSubPath(responseArea.getX(), mapDelay(chainResponse.groupDelaySamples[0]));
+
+		for (size_t i = 0; i < (size_t)w; i++)
+		{
+			groupDelayCurve.lineTo(responseArea.getX() + i, mapDelay(chainResponse.groupDelaySamples[i]));
+		}
 	}
+}
 
+void ResponseCurveComponent::resized()
+{
+	using namespace juce;
 
+	//rebuilt at the right scale by the next paint
+	background = Image();
 
-	g.setColour(Colours::orange);
-	g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
+	updateResponseCurve();
 
-	g.setColour(Colours::white);
-	g.strokePath(responsiveCurve, PathStrokeType(2.f));
+	//a software image, so writing a column is a plain memory write
+	auto analysisArea = getAnalysisArea();
+	if (!analysisArea.isEmpty())
+		spectrogram = Image(Image::PixelFormat::RGB, analysisArea.getWidth(),
+			jmin(analysisArea.getHeight(), SpectrogramColumnGenerator::maxNumRows), true, SoftwareImageType());
+	else
+		spectrogram = Image();
+
+	spectrogramWriteX = 0;
 }
 
-void ResponseCurveComponent::resized()
+void ResponseCurveComponent::updateBackground(float scale)
 {
 	using namespace juce;
 
-	background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
+	backgroundScale = scale;
+
+	if (getWidth() <= 0 || getHeight() <= 0)
+	{
+		background = Image();
+		return;
+	}
+
+	background = Image(Image::PixelFormat::RGB, jmax(1, roundToInt(getWidth() * scale)), jmax(1, roundToInt(getHeight() * scale)), true);
 
 	Graphics g(background);
+	g.addTransform(AffineTransform::scale(scale));
+
 	Array<float> freqs{
 		20.f,  50.f, 100.f,
 		200.f, 500.f, 1000.f,
@@ -559,33 +816,67 @@ void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float new
 {
 	parametersChanged.set(true);
 
+	//changes made in the editor shouldn't wait for an idle tick, host automation can
+	if (juce::MessageManager::existsAndIsCurrentThread() && refreshRateHz != 60)
+	{
+		idleTicks = 0;
+		setRefreshRate(60);
+	}
+
 }
 
 void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
 {
-	juce::AudioBuffer<float> tempIncomingBuffer;
+	/*
+	 FFTs run every 'hopSize' new samples, whatever the host block size is.
+	 this is called about once per displayed frame, and only the newest FFT of a frame
+	 would ever be seen, so when several hops are ready they are coalesced into one FFT
+	 over the latest samples.
+	 */
+	leftChannelFFTDataGenerator.changeOrder(order.load());
+
+	const auto windowSize = monoBuffer.getNumSamples();
+	const auto fftSize = leftChannelFFTDataGenerator.getFFTSize();
+	const auto hopSize = juce::jmax(1, fftSize * (100 - (int)overlap.load()) / 100);
 
-	while (leftChannelFifo->getNumCompleteBuffersAvailable() > 0)
 	{
-		if (leftChannelFifo->getAudioBuffer(tempIncomingBuffer))
+		//prepareToPlay may be reallocating the ring, try again next slice
+		const juce::SpinLock::ScopedTryLockType lock(leftChannelFifo->getConsumerLock());
+		if (!lock.isLocked() || !leftChannelFifo->isPrepared())
+			return;
+
+		auto numNewSamples = leftChannelFifo->getNumSamplesAvailable();
+
+		//anything older than one window can't contribute to the FFT
+		if (numNewSamples > windowSize)
 		{
-			auto size = tempIncomingBuffer.getNumSamples();
+			leftChannelFifo->discard(numNewSamples - windowSize);
+			numNewSamples = windowSize;
+		}
 
+		if (numNewSamples > 0)
+		{
+			//shift the existing samples down and append the new ones straight from the ring
 			juce::FloatVectorOperations::copy(
 				monoBuffer.getWritePointer(0, 0),
-				monoBuffer.getReadPointer(0, size),
-				monoBuffer.getNumSamples() - size);
+				monoBuffer.getReadPointer(0, numNewSamples),
+				windowSize - numNewSamples);
 
-			juce::FloatVectorOperations::copy(
-				monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-				tempIncomingBuffer.getReadPointer(0, 0),
-				size);
-
-			leftChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -48.f);
+			auto view = leftChannelFifo->beginRead(numNewSamples);
+			view.copyTo(monoBuffer.getWritePointer(0, windowSize - view.getNumSamples()));
+			leftChannelFifo->finishRead(view.getNumSamples());
 
+			samplesSinceLastFFT += view.getNumSamples();
 		}
+	}
 
+	if (samplesSinceLastFFT >= hopSize)
+	{
+		samplesPerFrame = samplesSinceLastFFT;
+		samplesSinceLastFFT = 0;
 
+		leftChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -48.f);
+		++numFFTsComputed;
 	}
 
 	/*
@@ -594,59 +885,145 @@ void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
 *       generate a path
 */
 
-	const auto fftSize = leftChannelFFTDataGenerator.getFFTSize();
-
-	/*
-	48000 / 2048 = 23Hz <-- this is the bin width
-	*/
-	const auto binWidth = sampleRate / (double)fftSize;
-
-
 	while (leftChannelFFTDataGenerator.getNumAvailableFFTDataBlocks() > 0)
 	{
-		std::vector<float>fftData;
-
 		if (leftChannelFFTDataGenerator.getFFTData(fftData))
 		{
-			pathProducer.generatePath(fftData, fftBounds, fftSize, binWidth, -48.f);
+			//a frame holds fftSize / 2 bins, so frames made before an order change are still drawn at their own size
+			const auto frameFFTSize = (int)fftData.size() * 2;
+
+			//the peak decay is per second, a frame covers the samples that came in since the previous FFT
+			const auto decayPerFrame = peakDecay.load() * (float)(samplesPerFrame / sampleRate);
+			averager.process(fftData.data(), (int)fftData.size(), averagingMode.load(), averagingFrames.load(), decayPerFrame);
+
+			/*
+			48000 / 2048 = 23Hz <-- this is the bin width
+			*/
+			const auto binWidth = sampleRate / (double)frameFFTSize;
+
+			//a silent frame after a silent frame would publish the same flat path again and cause a repaint for nothing
+			auto isSilent = juce::FloatVectorOperations::findMaximum(fftData.data(), (int)fftData.size()) <= -48.f + 0.01f;
+			auto isRepeat = isSilent && lastFrameWasSilent;
+			lastFrameWasSilent = isSilent;
+
+			if (spectrogramEnabled.load())
+				spectrogramGenerator.generateColumn(fftData, (int)fftBounds.getHeight(), frameFFTSize, binWidth, -48.f);
+			else if (!isRepeat)
+				pathProducer.generatePath(fftData, fftBounds, frameFFTSize, binWidth, -48.f);
 		}
 
 	}
 
-	/*
-	While there are paths that can be pulled,
-	pull as many as can be pulled.
+	//the newest path is now published, the message thread picks it up with acquireLatestPath()
+}
 
-	display the most recent path
+void PathProducer::setRenderParameters(juce::Rectangle<float> fftBounds, double sampleRate)
+{
+	boundsX.store(fftBounds.getX());
+	boundsY.store(fftBounds.getY());
+	boundsWidth.store(fftBounds.getWidth());
+	boundsHeight.store(fftBounds.getHeight());
+	renderSampleRate.store(sampleRate);
+}
+
+int PathProducer::useTimeSlice()
+{
+	auto fftBounds = juce::Rectangle<float>(boundsX.load(), boundsY.load(), boundsWidth.load(), boundsHeight.load());
+	auto sampleRate = renderSampleRate.load();
 
-	*/
+	if (!fftBounds.isEmpty() && sampleRate > 0.0)
+		process(fftBounds, sampleRate);
+
+	//roughly one display frame
+	return 1000 / 60;
+}
+void ResponseCurveComponent::writeSpectrogramColumn(const std::vector<float>& levels)
+{
+	//columns made for a different height (before a resize) are dropped
+	if (!spectrogram.isValid() || (int)levels.size() != spectrogram.getHeight())
+		return;
 
-	while (pathProducer.getNumPathsAvailable())
+	juce::Image::BitmapData pixels(spectrogram, spectrogramWriteX, 0, 1, spectrogram.getHeight(),
+		juce::Image::BitmapData::writeOnly);
+
+	const auto maxIndex = (float)(spectrogramColours.size() - 1);
+
+	for (int y = 0; y < pixels.height; ++y)
 	{
-		pathProducer.getPath(leftChannelFFTPath);
+		auto index = (size_t)(levels[(size_t)y] * maxIndex);
+		reinterpret_cast<juce::PixelRGB*>(pixels.getLinePointer(y))->set(spectrogramColours[index]);
 	}
 
+	spectrogramWriteX = (spectrogramWriteX + 1) % spectrogram.getWidth();
 }
+
 void ResponseCurveComponent::timerCallback()
 {
-	if (shouldShowFFTAnalysis)
+	updateAnalyzerAttachment();
+
+	auto needsRepaint = false;
+
+	if (analyzerAttached)
 	{
+		//the FFTs run on the analyzer thread, this only swaps in whatever it published last
 		auto fftBounds = getAnalysisArea().toFloat();
 		auto sampleRate = audioProcessor.getSampleRate();
 
-		leftPathProducer.process(fftBounds, sampleRate);
-		rightPathProducer.process(fftBounds, sampleRate);
+		auto fftOrder = (FFTOrder)(minFFTOrder + juce::roundToInt(analyzerResolution->load()));
+
+		leftPathProducer.setRenderParameters(fftBounds, sampleRate);
+		rightPathProducer.setRenderParameters(fftBounds, sampleRate);
+		leftPathProducer.setOrder(fftOrder);
+		rightPathProducer.setOrder(fftOrder);
+
+		//"25%", "50%", "75%"
+		setAnalyzerOverlap((AnalyzerOverlap)(25 * (1 + juce::jlimit(0, 2, juce::roundToInt(analyzerOverlap->load())))));
+
+		auto averaging = (AnalyzerAveraging)juce::roundToInt(analyzerAveraging->load());
+		auto averageFrames = juce::roundToInt(analyzerAverageFrames->load());
+		auto peakDecay = analyzerPeakDecay->load();
 
+		leftPathProducer.setAveraging(averaging, averageFrames, peakDecay);
+		rightPathProducer.setAveraging(averaging, averageFrames, peakDecay);
+
+		//the spectrogram shows the first producer's channel, neither producer builds line paths meanwhile
+		shouldShowSpectrogram = analyzerView->load() > 0.5f;
+		leftPathProducer.setSpectrogramEnabled(shouldShowSpectrogram);
+		rightPathProducer.setSpectrogramEnabled(shouldShowSpectrogram);
+
+		while (leftPathProducer.pullSpectrogramColumn(spectrogramColumn))
+		{
+			writeSpectrogramColumn(spectrogramColumn);
+			needsRepaint = true;
+		}
+
+		//not || : both have to be acquired
+		needsRepaint |= leftPathProducer.acquireLatestPath();
+		needsRepaint |= rightPathProducer.acquireLatestPath();
 	}
-	if (parametersChanged.compareAndSetBool(false, true))
+	if (parametersChanged.compareAndSetBool(false, true)
+		|| responseGrid.getSampleRate() != audioProcessor.getFilterSampleRate())
 	{
 		updateChain();
+		updateResponseCurve();
+		needsRepaint = true;
+	}
 
-
-
+	//only the plot changes, the labels around it are part of the background
+	if (needsRepaint)
+	{
+		repaint(getRenderArea().expanded(1));
+		idleTicks = 0;
+	}
+	else
+	{
+		++idleTicks;
 	}
 
-	repaint();
+	if (!isShowing())
+		setRefreshRate(4);
+	else
+		setRefreshRate(idleTicks * 1000 > 500 * refreshRateHz ? 10 : 60);
 }
 
 //==============================================================================
@@ -670,7 +1047,11 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcesso
 	lowcutBypassButtonAttachment(audioProcessor.apvts, audioProcessor.paramLowCutBypassed, lowcutBypassButton),
 	peakBypassButtonAttachment(audioProcessor.apvts, audioProcessor.paramPeakBypassed, peakBypassButton),
 	highcutBypassButtonAttachment(audioProcessor.apvts, audioProcessor.paramHighCutBypassed, highcutBypassButton),
-	analyzerEnabledButtonAttachment(audioProcessor.apvts, audioProcessor.paramAnalyzerEnabled, analyzerEnabledButton)
+	analyzerEnabledButtonAttachment(audioProcessor.apvts, audioProcessor.paramAnalyzerEnabled, analyzerEnabledButton),
+	showBandCurvesButtonAttachment(audioProcessor.apvts, audioProcessor.paramShowBandCurves, showBandCurvesButton),
+	showPhaseButtonAttachment(audioProcessor.apvts, audioProcessor.paramShowPhase, showPhaseButton),
+	showGroupDelayButtonAttachment(audioProcessor.apvts, audioProcessor.paramShowGroupDelay, showGroupDelayButton),
+	dspLoadMeterComponent(audioProcessor.getDspLoadMeter())
 
 {
 	// Make sure that before the constructor has finished, you've set the
@@ -697,7 +1078,13 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcesso
 	highCutSlopeSlider.labels.add({ 0.f, "12" });
 	highCutSlopeSlider.labels.add({ 1.f, "48" });
 
+	attachChoiceBox(analyzerViewBox, audioProcessor.paramAnalyzerView);
+	attachChoiceBox(analyzerAveragingBox, audioProcessor.paramAnalyzerAveraging);
+	attachChoiceBox(processingModeBox, audioProcessor.paramProcessingMode);
+	attachChoiceBox(oversamplingBox, audioProcessor.paramOversampling);
+	attachChoiceBox(peakDesignBox, audioProcessor.paramPeakDesign);
 
+	dspLoadMeterComponent.setAnalyzer(&responseCurveComponent.getAnalyzer());
 
 	for (auto* comp : getComps())
 	{
@@ -755,7 +1142,17 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcesso
 	};
 
 
-	setSize(600, 480);
+	setSize(600, 510);
+}
+
+void SimpleEQAudioProcessorEditor::attachChoiceBox(juce::ComboBox& box, const juce::String& paramID)
+{
+	auto* choice = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter(paramID));
+	jassert(choice != nullptr);
+
+	box.addItemList(choice->choices, 1);
+	box.setTooltip(paramID);
+	comboBoxAttachments.push_back(std::make_unique<ComboBoxAttachment>(audioProcessor.apvts, paramID, box));
 }
 
 SimpleEQAudioProcessorEditor::~SimpleEQAudioProcessorEditor()
@@ -787,11 +1184,27 @@ void SimpleEQAudioProcessorEditor::resized()
 	auto bounds = getLocalBounds();
 
 	auto analyzerEnableArea = bounds.removeFromTop(25);
+	dspLoadMeterComponent.setBounds(analyzerEnableArea.removeFromRight(260).reduced(2));
+
+	//overlay toggles between the analyzer button and the load meter
+	auto overlayArea = analyzerEnableArea.removeFromRight(analyzerEnableArea.getWidth() - 110);
+	auto overlayWidth = overlayArea.getWidth() / 3;
+	showBandCurvesButton.setBounds(overlayArea.removeFromLeft(overlayWidth));
+	showPhaseButton.setBounds(overlayArea.removeFromLeft(overlayWidth));
+	showGroupDelayButton.setBounds(overlayArea);
+
 	analyzerEnableArea.setWidth(100);
 	analyzerEnableArea.setX(5);
 	analyzerEnableArea.removeFromTop(2);
 
 	analyzerEnabledButton.setBounds(analyzerEnableArea);
+
+	auto optionsArea = bounds.removeFromTop(25).reduced(5, 2);
+	auto boxWidth = optionsArea.getWidth() / 5;
+	for (auto* box : { &analyzerViewBox, &analyzerAveragingBox, &processingModeBox, &oversamplingBox })
+		box->setBounds(optionsArea.removeFromLeft(boxWidth).reduced(2, 0));
+	peakDesignBox.setBounds(optionsArea.reduced(2, 0));
+
 	bounds.removeFromTop(5);
 
 	auto hRatio = 25.f / 100.f; //JUCE_LIVE_CONSTANT(33) / 100.f;
@@ -838,6 +1251,16 @@ std::vector<juce::Component*> SimpleEQAudioProcessorEditor::getComps()
 		&lowcutBypassButton,
 		&peakBypassButton,
 		&highcutBypassButton,
-		&analyzerEnabledButton
+		&analyzerEnabledButton,
+		&dspLoadMeterComponent,
+
+		&showBandCurvesButton,
+		&showPhaseButton,
+		&showGroupDelayButton,
+		&analyzerViewBox,
+		&analyzerAveragingBox,
+		&processingModeBox,
+		&oversamplingBox,
+		&peakDesignBox
 	};
 }
\ No newline at end of file
@@ -18,87 +18,300 @@ enum FFTOrder
 	order8192 = 13
 };
 
+static constexpr FFTOrder minFFTOrder = FFTOrder::order2048, maxFFTOrder = FFTOrder::order8192;
+static constexpr int numFFTOrders = maxFFTOrder - minFFTOrder + 1;
+
+//how much consecutive analyzer FFT frames overlap, in percent of the FFT size
+enum AnalyzerOverlap
+{
+	overlap25 = 25,
+	overlap50 = 50,
+	overlap75 = 75
+};
+
+/*
+ log2(x) for finite, normal x > 0 without a libm call, so loops using it can be vectorized.
+ the exponent comes straight from the float's bits. the mantissa is folded into [sqrt(1/2), sqrt(2))
+ and goes through the atanh series log2(m) = 2/ln(2) * (t + t^3/3 + t^5/5), t = (m - 1) / (m + 1).
+ with |t| < 0.172 the error is below 3e-6, about 2e-5 dB.
+ */
+inline float fastLog2(float x)
+{
+	juce::uint32 bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+
+	//mantissas from sqrt(2) up are halved, which moves one into the exponent.
+	//done with integer maths because a compare and select would keep the loop from vectorizing
+	const auto mantissaBits = bits & 0x007fffffu;
+	const auto fold = (mantissaBits + 0x004afb0du) >> 23;
+
+	const auto exponent = (float)((int)((bits >> 23) & 0xff) - 127 + (int)fold);
+
+	bits = mantissaBits | (0x3f800000u - (fold << 23));
+	float mantissa;
+	std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+	constexpr float c1 = 2.8853900817779268f, c3 = c1 / 3.f, c5 = c1 / 5.f;
+
+	const auto t = (mantissa - 1.f) / (mantissa + 1.f);
+	const auto t2 = t * t;
+
+	return exponent + t * (c1 + t2 * (c3 + t2 * c5));
+}
+
+/*
+ FFT magnitudes -> normalized -> decibels, in place.
+ NaNs, infs and anything below 'negativeInfinity' end up at 'negativeInfinity', like juce::Decibels::gainToDecibels.
+ the loop has no branches so the compiler can vectorize it.
+ */
+inline void magnitudesToDecibels(float* data, int numBins, float negativeInfinity)
+{
+	juce::FloatVectorOperations::multiply(data, 1.f / (float)numBins, numBins);
+
+	const auto floorGain = juce::Decibels::decibelsToGain(negativeInfinity, negativeInfinity - 1.f);
+	constexpr float decibelsPerOctave = 6.0205999132796239f; //20 * log10(2)
+
+	for (int i = 0; i < numBins; ++i)
+	{
+		auto v = data[i];
+		v = v > floorGain ? v : floorGain; //NaNs fail the comparison
+		v = v < std::numeric_limits<float>::max() ? v : floorGain;
+		data[i] = decibelsPerOctave * fastLog2(v);
+	}
+}
+
 template<typename BlockType>
 struct FFTDataGenerator
 {
+	FFTDataGenerator()
+	{
+		//the FFT and window for every order are built up front, so changeOrder() never allocates
+		for (int i = 0; i < numFFTOrders; ++i)
+		{
+			auto fftOrder = minFFTOrder + i;
+
+			forwardFFTs[(size_t)i] = std::make_unique<juce::dsp::FFT>(fftOrder);
+			windows[(size_t)i] = std::make_unique<juce::dsp::WindowingFunction<float>>(1 << fftOrder,
+				juce::dsp::WindowingFunction<float>::blackmanHarris);
+		}
+
+		fftData.resize(getMaxFFTSize() * 2, 0);
+
+		//frames only carry the bins of the order they were made with
+		fftDataFifo.prepare(getMaxFFTSize() / 2);
+	}
+
 	/**
-	 produces the FFT data from an audio buffer.
+	 produces the FFT data from the newest getFFTSize() samples of an audio buffer.
 	 */
 	void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
 	{
 		const auto fftSize = getFFTSize();
+		jassert(audioData.getNumSamples() >= fftSize);
 
-		fftData.assign(fftData.size(), 0);
-		auto* readIndex = audioData.getReadPointer(0);
+		//only the first half is input, the FFT overwrites the rest, so nothing needs clearing
+		auto* readIndex = audioData.getReadPointer(0, audioData.getNumSamples() - fftSize);
 		std::copy(readIndex, readIndex + fftSize, fftData.begin());
 
 		// first apply a windowing function to our data
-		window->multiplyWithWindowingTable(fftData.data(), fftSize);       // [1]
+		getWindow().multiplyWithWindowingTable(fftData.data(), fftSize);       // [1]
 
 		// then render our FFT data..
-		forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());  // [2]
+		getForwardFFT().performFrequencyOnlyForwardTransform(fftData.data());  // [2]
 
 		int numBins = (int)fftSize / 2;
 
-		//normalize the fft values.
-		for (int i = 0; i < numBins; ++i)
+		//normalize the fft values and convert them to decibels
+		magnitudesToDecibels(fftData.data(), numBins, negativeInfinity);
+
+		fftDataFifo.push(fftData.data(), numBins);
+	}
+
+	//only picks which of the preallocated FFTs is used, safe to call between frames
+	void changeOrder(FFTOrder newOrder)
+	{
+		jassert(newOrder >= minFFTOrder && newOrder <= maxFFTOrder);
+		order = newOrder;
+	}
+	//==============================================================================
+	int getFFTSize() const { return 1 << order; }
+	static constexpr int getMaxFFTSize() { return 1 << maxFFTOrder; }
+	int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
+	//==============================================================================
+	bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
+private:
+	FFTOrder order = minFFTOrder;
+	BlockType fftData;
+	std::array<std::unique_ptr<juce::dsp::FFT>, numFFTOrders> forwardFFTs;
+	std::array<std::unique_ptr<juce::dsp::WindowingFunction<float>>, numFFTOrders> windows;
+
+	juce::dsp::FFT& getForwardFFT() { return *forwardFFTs[(size_t)(order - minFFTOrder)]; }
+	juce::dsp::WindowingFunction<float>& getWindow() { return *windows[(size_t)(order - minFFTOrder)]; }
+
+	Fifo<BlockType> fftDataFifo;
+};
+
+enum class AnalyzerAveraging
+{
+	Off,
+	Exponential,
+	MovingAverage,
+	PeakHold
+};
+
+/*
+ smooths consecutive analyzer frames in place, frames are in dB.
+ every mode costs O(bins) per frame, and the state for the largest frame and the longest
+ moving average is allocated up front. changing the mode, frame count or frame size starts over.
+ */
+struct AnalyzerAverager
+{
+	static constexpr int maxNumFrames = 32;
+
+	explicit AnalyzerAverager(int maxBins) :
+		maxNumBins(maxBins),
+		state((size_t)maxBins, 0.f),
+		sums((size_t)maxBins, 0.0),
+		history((size_t)(maxBins * maxNumFrames), 0.f)
+	{
+	}
+
+	/*
+	 'numFrames' sets the length of the moving average, and the exponential average uses the
+	 same span: alpha = 2 / (numFrames + 1).
+	 'decayInDecibels' is how far a held peak falls in this frame.
+	 */
+	void process(float* frame, int numBins, AnalyzerAveraging newMode, int newNumFrames, float decayInDecibels)
+	{
+		jassert(numBins <= maxNumBins);
+		newNumFrames = juce::jlimit(1, maxNumFrames, newNumFrames);
+
+		if (newMode != mode || numBins != activeNumBins || newNumFrames != numFrames)
+		{
+			mode = newMode;
+			activeNumBins = numBins;
+			numFrames = newNumFrames;
+			numFramesSeen = 0;
+			historyIndex = 0;
+		}
+
+		using FVO = juce::FloatVectorOperations;
+
+		switch (mode)
+		{
+		case AnalyzerAveraging::Off:
+			return;
+		case AnalyzerAveraging::Exponential:
 		{
-			auto v = fftData[i];
-			//            fftData[i] /= (float) numBins;
-			if (!std::isinf(v) && !std::isnan(v))
+			if (numFramesSeen == 0)
 			{
-				v /= float(numBins);
+				FVO::copy(state.data(), frame, numBins);
 			}
 			else
 			{
-				v = 0.f;
+				const auto alpha = 2.f / (float)(numFrames + 1);
+				FVO::multiply(state.data(), 1.f - alpha, numBins);
+				FVO::addWithMultiply(state.data(), frame, alpha, numBins);
 			}
-			fftData[i] = v;
+
+			FVO::copy(frame, state.data(), numBins);
+			break;
 		}
+		case AnalyzerAveraging::MovingAverage:
+		{
+			//running sums, the oldest frame in the ring leaves as the new one enters
+			auto* slot = history.data() + (size_t)(historyIndex * maxNumBins);
+			const auto isFull = numFramesSeen >= numFrames;
+
+			if (numFramesSeen == 0)
+				std::fill(sums.begin(), sums.begin() + numBins, 0.0);
+
+			const auto scale = 1.0 / (double)juce::jmin(numFramesSeen + 1, numFrames);
+
+			for (int i = 0; i < numBins; ++i)
+			{
+				auto sum = sums[(size_t)i] + frame[i] - (isFull ? slot[i] : 0.f);
+				sums[(size_t)i] = sum;
+				slot[i] = frame[i];
+				frame[i] = (float)(sum * scale);
+			}
 
-		//convert them to decibels
-		for (int i = 0; i < numBins; ++i)
+			historyIndex = (historyIndex + 1) % numFrames;
+			break;
+		}
+		case AnalyzerAveraging::PeakHold:
 		{
-			fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
+			if (numFramesSeen == 0)
+			{
+				FVO::copy(state.data(), frame, numBins);
+			}
+			else
+			{
+				FVO::add(state.data(), -decayInDecibels, numBins);
+				FVO::max(state.data(), state.data(), frame, numBins);
+			}
+
+			FVO::copy(frame, state.data(), numBins);
+			break;
+		}
 		}
 
-		fftDataFifo.push(fftData);
+		numFramesSeen = juce::jmin(numFramesSeen + 1, maxNumFrames);
 	}
+private:
+	const int maxNumBins;
+	std::vector<float> state;
+	std::vector<double> sums;
+	std::vector<float> history;
 
-	void changeOrder(FFTOrder newOrder)
-	{
-		//when you change order, recreate the window, forwardFFT, fifo, fftData
-		//also reset the fifoIndex
-		//things that need recreating should be created on the heap via std::make_unique<>
+	AnalyzerAveraging mode = AnalyzerAveraging::Off;
+	int activeNumBins = 0, numFrames = 1, numFramesSeen = 0, historyIndex = 0;
+};
 
-		order = newOrder;
-		auto fftSize = getFFTSize();
+/*
+ lock-free hand-over of the most recent value from one writer thread to one reader thread.
+ the writer fills getWriteBuffer() and calls publish(); the reader calls acquire() and then uses getReadBuffer().
+ both sides only swap indices, so nobody waits and nothing is copied.
+ */
+template<typename T>
+struct TripleBuffer
+{
+	T& getWriteBuffer() { return buffers[(size_t)writeIndex]; }
 
-		forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-		window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+	void publish()
+	{
+		auto previous = middle.exchange(writeIndex | newDataFlag);
+		writeIndex = previous & indexMask;
+	}
 
-		fftData.clear();
-		fftData.resize(fftSize * 2, 0);
+	//returns true if a new value was published since the last call
+	bool acquire()
+	{
+		if ((middle.load() & newDataFlag) == 0)
+			return false;
 
-		fftDataFifo.prepare(fftData.size());
+		auto previous = middle.exchange(readIndex);
+		readIndex = previous & indexMask;
+		return true;
 	}
-	//==============================================================================
-	int getFFTSize() const { return 1 << order; }
-	int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
-	//==============================================================================
-	bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
+
+	const T& getReadBuffer() const { return buffers[(size_t)readIndex]; }
 private:
-	FFTOrder order;
-	BlockType fftData;
-	std::unique_ptr<juce::dsp::FFT> forwardFFT;
-	std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+	static constexpr int indexMask = 3, newDataFlag = 4;
 
-	Fifo<BlockType> fftDataFifo;
+	std::array<T, 3> buffers;
+	int writeIndex = 0, readIndex = 1;
+	std::atomic<int> middle{ 2 };
 };
 
 template<typename PathType>
 struct AnalyzerPathGenerator
 {
+	AnalyzerPathGenerator()
+	{
+		binToX.reserve((size_t)(1 << maxFFTOrder) / 2);
+	}
+
 	/*
 	 converts 'renderData[]' into a juce::Path
 	 */
@@ -114,8 +327,13 @@ struct AnalyzerPathGenerator
 
 		int numBins = (int)fftSize / 2;
 
-		PathType p;
-		p.preallocateSpace(3 * (int)fftBounds.getWidth());
+		if (width != tableWidth || fftSize != tableFFTSize || binWidth != tableBinWidth)
+			rebuildBinToXTable(width, fftSize, binWidth);
+
+		auto& p = paths.getWriteBuffer();
+		p.clear();
+		//at most two vertices per pixel column, three coordinates each
+		p.preallocateSpace(6 * ((int)width + 2));
 
 		auto map = [bottom, top, negativeInfinity](float v)
 		{
@@ -124,47 +342,187 @@ struct AnalyzerPathGenerator
 				float(bottom + 10), top);
 		};
 
+		auto isValid = [](float y) { return !std::isnan(y) && !std::isinf(y); };
+
 		auto y = map(renderData[0]);
 
 		//        jassert( !std::isnan(y) && !std::isinf(y) );
-		if (std::isnan(y) || std::isinf(y))
+		if (!isValid(y))
 			y = bottom;
 
 		p.startNewSubPath(0, y);
 
-		const int pathResolution = 2; //you can draw line-to's every 'pathResolution' pixels.
+		/*
+		 above a few hundred Hz many bins land on the same pixel column.
+		 each column only gets a line to the loudest and the quietest of its bins.
+		 */
+		auto addColumn = [&](int x, float lowest, float highest)
+		{
+			auto yHigh = map(highest);
+			auto yLow = map(lowest);
 
-		for (int binNum = 1; binNum < numBins; binNum += pathResolution)
+			if (isValid(yHigh))
+				p.lineTo(x, yHigh);
+			if (yLow != yHigh && isValid(yLow))
+				p.lineTo(x, yLow);
+		};
+
+		int column = -1;
+		float lowest = 0.f, highest = 0.f;
+
+		for (int binNum = firstVisibleBin; binNum < juce::jmin(endVisibleBin, numBins); ++binNum)
 		{
-			y = map(renderData[binNum]);
+			auto v = renderData[(size_t)binNum];
+			auto binX = binToX[(size_t)binNum];
 
-			//            jassert( !std::isnan(y) && !std::isinf(y) );
+			if (binX != column)
+			{
+				if (column >= 0)
+					addColumn(column, lowest, highest);
 
-			if (!std::isnan(y) && !std::isinf(y))
+				column = binX;
+				lowest = highest = v;
+			}
+			else
 			{
-				auto binFreq = binNum * binWidth;
-				auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-				int binX = std::floor(normalizedBinX * width);
-				p.lineTo(binX, y);
+				lowest = juce::jmin(lowest, v);
+				highest = juce::jmax(highest, v);
 			}
 		}
 
-		pathFifo.push(p);
+		if (column >= 0)
+			addColumn(column, lowest, highest);
+
+		paths.publish();
 	}
 
-	int getNumPathsAvailable() const
+	//reader side: returns true if a newer path than the last one acquired is now available
+	bool acquireLatestPath() { return paths.acquire(); }
+	const PathType& getLatestPath() const { return paths.getReadBuffer(); }
+private:
+	TripleBuffer<PathType> paths;
+
+	//pixel column of every bin, only rebuilt when the width, FFT size or bin width change
+	std::vector<int> binToX;
+	int firstVisibleBin = 1, endVisibleBin = 1;
+	float tableWidth = -1.f, tableBinWidth = -1.f;
+	int tableFFTSize = -1;
+
+	void rebuildBinToXTable(float width, int fftSize, float binWidth)
+	{
+		tableWidth = width;
+		tableFFTSize = fftSize;
+		tableBinWidth = binWidth;
+
+		const int numBins = fftSize / 2;
+		binToX.resize((size_t)numBins);
+
+		//bin 0 is DC, it only provides the start of the path
+		binToX[0] = 0;
+		firstVisibleBin = numBins;
+		endVisibleBin = 1;
+
+		for (int binNum = 1; binNum < numBins; ++binNum)
+		{
+			auto binFreq = binNum * binWidth;
+			auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
+			int binX = (int)std::floor(normalizedBinX * width);
+			binToX[(size_t)binNum] = binX;
+
+			//the mapping only grows, so the bins between 20Hz and 20kHz are one contiguous range
+			if (binX >= 0 && binX <= width)
+			{
+				firstVisibleBin = juce::jmin(firstVisibleBin, binNum);
+				endVisibleBin = binNum + 1;
+			}
+		}
+	}
+};
+
+/*
+ turns analyzer frames into spectrogram columns: one level per pixel row, 0 (negativeInfinity) to 1 (0 dB),
+ top row = 20kHz, bottom row = 20Hz, log spaced.
+ columns go to the message thread through a Fifo whose buffers are allocated up front for the tallest column.
+ */
+struct SpectrogramColumnGenerator
+{
+	static constexpr int maxNumRows = 4320;
+
+	SpectrogramColumnGenerator()
 	{
-		return pathFifo.getNumAvailableForReading();
+		column.resize(maxNumRows, 0.f);
+		rowBins.reserve(maxNumRows);
+		columns.prepare(maxNumRows);
 	}
 
-	bool getPath(PathType& path)
+	//analyzer thread
+	void generateColumn(const std::vector<float>& renderData,
+		int numRows,
+		int fftSize,
+		float binWidth,
+		float negativeInfinity)
 	{
-		return pathFifo.pull(path);
+		numRows = juce::jlimit(1, maxNumRows, numRows);
+
+		if (numRows != tableNumRows || fftSize != tableFFTSize || binWidth != tableBinWidth)
+			rebuildRowTable(numRows, fftSize, binWidth);
+
+		for (int row = 0; row < numRows; ++row)
+		{
+			auto [firstBin, lastBin] = rowBins[(size_t)row];
+
+			//rows spanning several bins show the loudest one
+			auto level = renderData[(size_t)firstBin];
+			for (int binNum = firstBin + 1; binNum <= lastBin; ++binNum)
+				level = juce::jmax(level, renderData[(size_t)binNum]);
+
+			column[(size_t)row] = juce::jlimit(0.f, 1.f, juce::jmap(level, negativeInfinity, 0.f, 0.f, 1.f));
+		}
+
+		columns.push(column.data(), numRows);
 	}
+
+	//message thread
+	bool pullColumn(std::vector<float>& dest) { return columns.pull(dest); }
 private:
-	Fifo<PathType> pathFifo;
+	std::vector<float> column;
+	Fifo<std::vector<float>> columns;
+
+	//first and last bin of every row, only rebuilt when the height, FFT size or bin width change
+	std::vector<std::pair<int, int>> rowBins;
+	int tableNumRows = -1, tableFFTSize = -1;
+	float tableBinWidth = -1.f;
+
+	void rebuildRowTable(int numRows, int fftSize, float binWidth)
+	{
+		tableNumRows = numRows;
+		tableFFTSize = fftSize;
+		tableBinWidth = binWidth;
+
+		const int lastUsableBin = fftSize / 2 - 1;
+		rowBins.resize((size_t)numRows);
+
+		for (int row = 0; row < numRows; ++row)
+		{
+			auto highFreq = juce::mapToLog10(1.f - (float)row / (float)numRows, 20.f, 20000.f);
+			auto lowFreq = juce::mapToLog10(1.f - (float)(row + 1) / (float)numRows, 20.f, 20000.f);
+
+			auto firstBin = (int)std::ceil(lowFreq / binWidth);
+			auto lastBin = (int)std::floor(highFreq / binWidth);
+
+			//at the low end there are more rows than bins, those rows use the nearest bin
+			if (lastBin < firstBin)
+				firstBin = lastBin = juce::roundToInt(std::sqrt(lowFreq * highFreq) / binWidth);
+
+			firstBin = juce::jlimit(1, lastUsableBin, firstBin);
+			lastBin = juce::jlimit(firstBin, lastUsableBin, lastBin);
+
+			rowBins[(size_t)row] = { firstBin, lastBin };
+		}
+	}
 };
 
+struct RotarySliderWithLabels;
 
 struct LookAndFeel : juce::LookAndFeel_V4
 {
@@ -172,6 +530,14 @@ struct LookAndFeel : juce::LookAndFeel_V4
 		float sliderPosProportional, float rotaryStartAngle,
 		float rotaryEndAngle, juce::Slider&) override;
 
+	/*
+	 drawRotarySlider in two layers: the body doesn't move, so RotarySliderWithLabels caches it in an image.
+	 the pointer is the unrotated path from RotarySliderWithLabels::makePointerPath.
+	 */
+	void drawRotarySliderBody(juce::Graphics&, juce::Rectangle<float> bounds, bool enabled);
+	void drawRotarySliderPointer(juce::Graphics&, juce::Rectangle<float> bounds, const juce::Path& pointer,
+		float angle, bool enabled, const RotarySliderWithLabels&);
+
 
 
 	void drawToggleButton(juce::Graphics&,
@@ -186,9 +552,14 @@ struct RotarySliderWithLabels : public juce::Slider
 	RotarySliderWithLabels(juce::RangedAudioParameter& rap, const juce::String& unitSuffix) :
 		juce::Slider(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag, juce::Slider::TextEntryBoxPosition::NoTextBox),
 		param(&rap),
+		choiceParam(dynamic_cast<juce::AudioParameterChoice*>(&rap)),
+		floatParam(dynamic_cast<juce::AudioParameterFloat*>(&rap)),
 		suffix(unitSuffix)
 	{
+		jassert(choiceParam != nullptr || floatParam != nullptr);
+
 		setLookAndFeel(&lnf);
+		displayString = getDisplayString();
 	}
 
 	~RotarySliderWithLabels()
@@ -205,26 +576,100 @@ struct RotarySliderWithLabels : public juce::Slider
 	juce::Array<LabelPos> labels;
 
 	void paint(juce::Graphics&) override;
+	void resized() override
+	{
+		juce::Slider::resized();
+		staticLayer = juce::Image();
+	}
+
+	void enablementChanged() override
+	{
+		juce::Slider::enablementChanged();
+		staticLayer = juce::Image();
+	}
+
+	//the value text is rebuilt when the value changes, not on every paint
+	void valueChanged() override { displayString = getDisplayString(); }
+
 	juce::Rectangle<int> getSliderBounds() const;
 	int getTextHeight() const { return 14; }
 	juce::String getDisplayString() const;
+	const juce::String& getCachedDisplayString() const { return displayString; }
+
+	//the pointer at 12 o'clock, drawRotarySliderPointer rotates it
+	static juce::Path makePointerPath(juce::Rectangle<float> sliderBounds, int textHeight);
 private:
 	LookAndFeel lnf;
 	juce::RangedAudioParameter* param;
+
+	//resolved once, getDisplayString() used to dynamic_cast on every paint
+	juce::AudioParameterChoice* choiceParam;
+	juce::AudioParameterFloat* floatParam;
+
 	juce::String suffix;
+	juce::String displayString;
+
+	/*
+	 the body and the labels, rendered at the physical pixel scale they are drawn at.
+	 only rebuilt when the size, the scale or the enablement change.
+	 */
+	juce::Image staticLayer;
+	float staticLayerScale = 0.f;
+	juce::Path pointerPath;
+
+	void updateStaticLayer(float scale);
+};
+
+/*
+ one thread shared by every open editor, running the analyzers' FIFO draining, FFTs and path building.
+ */
+struct AnalyzerThread : public juce::TimeSliceThread
+{
+	AnalyzerThread() : juce::TimeSliceThread("SimpleEQ Analyzer") { startThread(); }
+	~AnalyzerThread() override { stopThread(1000); }
 };
 
-struct PathProducer
+struct PathProducer : public juce::TimeSliceClient
 {
 	PathProducer(SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>& scsf) :
 		leftChannelFifo(&scsf)
 	{
+		//sized for the largest order, so it always holds enough history whatever order is picked
+		monoBuffer.setSize(1, leftChannelFFTDataGenerator.getMaxFFTSize());
+		fftData.reserve((size_t)leftChannelFFTDataGenerator.getMaxFFTSize() / 2);
+	}
 
-		leftChannelFFTDataGenerator.changeOrder(FFTOrder::order2048);
-		monoBuffer.setSize(1, leftChannelFFTDataGenerator.getFFTSize());
+	//message thread: where the next paths should be drawn
+	void setRenderParameters(juce::Rectangle<float> fftBounds, double sampleRate);
+	void setOverlap(AnalyzerOverlap newOverlap) { overlap.store(newOverlap); }
+	void setOrder(FFTOrder newOrder) { order.store(newOrder); }
+	void setSpectrogramEnabled(bool enabled) { spectrogramEnabled.store(enabled); }
+	void setAveraging(AnalyzerAveraging newMode, int numFrames, float peakDecayInDecibelsPerSecond)
+	{
+		averagingMode.store(newMode);
+		averagingFrames.store(numFrames);
+		peakDecay.store(peakDecayInDecibelsPerSecond);
 	}
+
+	//analyzer thread
+	int useTimeSlice() override;
 	void process(juce::Rectangle<float> fftBounds, double sampleRate);
-	juce::Path getPath() { return leftChannelFFTPath; }
+
+	//message thread: swaps in the newest published path, returns false if there isn't a new one
+	bool acquireLatestPath()
+	{
+		if (!pathProducer.acquireLatestPath())
+			return false;
+
+		++numFramesDisplayed;
+		return true;
+	}
+
+	const juce::Path& getPath() const { return pathProducer.getLatestPath(); }
+	bool pullSpectrogramColumn(std::vector<float>& dest) { return spectrogramGenerator.pullColumn(dest); }
+
+	juce::int64 getNumFFTsComputed() const { return numFFTsComputed.get(); }
+	juce::int64 getNumFramesDisplayed() const { return numFramesDisplayed.get(); }
 private:
 	SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>* leftChannelFifo;
 
@@ -233,8 +678,24 @@ private:
 	FFTDataGenerator< std::vector<float> > leftChannelFFTDataGenerator;
 
 	AnalyzerPathGenerator<juce::Path> pathProducer;
+	SpectrogramColumnGenerator spectrogramGenerator;
+
+	std::vector<float> fftData;
+
+	AnalyzerAverager averager{ leftChannelFFTDataGenerator.getMaxFFTSize() / 2 };
+
+	std::atomic<float> boundsX{ 0.f }, boundsY{ 0.f }, boundsWidth{ 0.f }, boundsHeight{ 0.f };
+	std::atomic<double> renderSampleRate{ 0.0 };
+	std::atomic<AnalyzerOverlap> overlap{ AnalyzerOverlap::overlap50 };
+	std::atomic<FFTOrder> order{ minFFTOrder };
+	std::atomic<AnalyzerAveraging> averagingMode{ AnalyzerAveraging::Off };
+	std::atomic<int> averagingFrames{ 8 };
+	std::atomic<float> peakDecay{ 12.f };
+	std::atomic<bool> spectrogramEnabled{ false };
 
-	juce::Path leftChannelFFTPath;
+	int samplesSinceLastFFT = 0, samplesPerFrame = 0;
+	bool lastFrameWasSilent = false;
+	juce::Atomic<juce::int64> numFFTsComputed = 0, numFramesDisplayed = 0;
 };
 
 struct ResponseCurveComponent : public juce::Component,
@@ -251,10 +712,20 @@ struct ResponseCurveComponent : public juce::Component,
 
 	void timerCallback() override;
 
-	void toggleAnalysisEnablement(bool enabled)
+	void toggleAnalysisEnablement(bool enabled);
+
+	//renders the grid and labels at 'scale' physical pixels per logical pixel, paint() calls it when the scale changes
+	void updateBackground(float scale);
+	const juce::Image& getBackground() const { return background; }
+
+	void setAnalyzerOverlap(AnalyzerOverlap newOverlap)
 	{
-		shouldShowFFTAnalysis = enabled;
+		leftPathProducer.setOverlap(newOverlap);
+		rightPathProducer.setOverlap(newOverlap);
 	}
+
+	//both channels run the same hops, so one of them stands for the analyzer's counts
+	const PathProducer& getAnalyzer() const { return leftPathProducer; }
 private:
 	SimpleEQAudioProcessor& audioProcessor;
 	juce::Atomic<bool> parametersChanged = { false };
@@ -262,16 +733,94 @@ private:
 	MonoChain monoChain;
 	void updateChain();
 
+	//the response curve and its overlays are only re-evaluated when the chain, the size or the sample rate change
+	FrequencyResponseGrid responseGrid;
+	ChainResponse chainResponse;
+	juce::Path responseCurve;
+	std::array<juce::Path, 3> bandCurves; //indexed by ChainPositions
+	juce::Path phaseCurve, groupDelayCurve;
+	void updateResponseCurve();
+
+	std::atomic<float>* showBandCurves = nullptr;
+	std::atomic<float>* showPhase = nullptr;
+	std::atomic<float>* showGroupDelay = nullptr;
+
 	juce::Image background;
+	float backgroundScale = 0.f;
 
 	juce::Rectangle<int> getRenderArea();
 	juce::Rectangle<int> getAnalysisArea();
 
+	juce::SharedResourcePointer<AnalyzerThread> analyzerThread;
 	PathProducer leftPathProducer, rightPathProducer;
 
+	std::atomic<float>* analyzerResolution = nullptr;
+	std::atomic<float>* analyzerOverlap = nullptr;
+	std::atomic<float>* analyzerAveraging = nullptr;
+	std::atomic<float>* analyzerAverageFrames = nullptr;
+	std::atomic<float>* analyzerPeakDecay = nullptr;
+	std::atomic<float>* analyzerView = nullptr;
+
+	/*
+	 the spectrogram is a ring of columns: 'spectrogramWriteX' is the next column to be replaced,
+	 which is also the oldest one. paint() draws it as two unscaled blits.
+	 */
+	juce::Image spectrogram;
+	int spectrogramWriteX = 0;
+	std::vector<float> spectrogramColumn;
+	std::array<juce::PixelARGB, 256> spectrogramColours;
+	bool shouldShowSpectrogram = false;
+
+	void writeSpectrogramColumn(const std::vector<float>& levels);
+
 	bool shouldShowFFTAnalysis = true;
+	bool analyzerAttached = false;
+
+	//the analyzer only runs while it is wanted and the editor is actually on screen
+	void updateAnalyzerAttachment();
+
+	/*
+	 the timer runs at 60Hz while something is changing, drops to 10Hz after half a second
+	 without new frames or parameter changes, and to 4Hz while the editor isn't showing.
+	 */
+	void setRefreshRate(int newRateHz);
+	int refreshRateHz = 0;
+	int idleTicks = 0;
 
 
+};
+//==============================================================================
+/*
+ shows the processor's DspLoadMeter: current/max/p99 load, overruns and the load histogram.
+ with an analyzer set, a second line compares its FFTs computed with the frames actually displayed.
+ */
+struct DspLoadMeterComponent : public juce::Component,
+	public juce::Timer
+{
+	DspLoadMeterComponent(const DspLoadMeter& meter) : loadMeter(meter)
+	{
+		startTimerHz(10);
+	}
+
+	void paint(juce::Graphics&) override;
+
+	void setAnalyzer(const PathProducer* producer) { analyzer = producer; }
+
+	void timerCallback() override
+	{
+		//the numbers only move while the processor is running
+		auto numBlocks = loadMeter.getNumBlocks();
+
+		if (numBlocks != lastNumBlocks && isShowing())
+		{
+			lastNumBlocks = numBlocks;
+			repaint();
+		}
+	}
+private:
+	const DspLoadMeter& loadMeter;
+	const PathProducer* analyzer = nullptr;
+	juce::int64 lastNumBlocks = -1;
 };
 //==============================================================================
 struct PowerButton : juce::ToggleButton{};
@@ -341,11 +890,28 @@ private:
 	PowerButton lowcutBypassButton, peakBypassButton, highcutBypassButton;
 	AnalyzerButton analyzerEnabledButton;
 
+	DspLoadMeterComponent dspLoadMeterComponent;
+
+	//response curve overlays, next to the analyzer button
+	juce::ToggleButton showBandCurvesButton{ "Bands" }, showPhaseButton{ "Phase" }, showGroupDelayButton{ "Delay" };
+
+	//the choice parameters without a rotary, in a row under the analyzer button. the tooltips name them
+	juce::ComboBox analyzerViewBox, analyzerAveragingBox, processingModeBox, oversamplingBox, peakDesignBox;
+	juce::TooltipWindow tooltipWindow{ this };
+
 	using ButtonAttachment = APVTS::ButtonAttachment;
 	ButtonAttachment lowcutBypassButtonAttachment,
 		peakBypassButtonAttachment,
 		highcutBypassButtonAttachment,
-		analyzerEnabledButtonAttachment;
+		analyzerEnabledButtonAttachment,
+		showBandCurvesButtonAttachment,
+		showPhaseButtonAttachment,
+		showGroupDelayButtonAttachment;
+
+	//made in the constructor, a ComboBoxAttachment needs the items to be there already
+	using ComboBoxAttachment = APVTS::ComboBoxAttachment;
+	std::vector<std::unique_ptr<ComboBoxAttachment>> comboBoxAttachments;
+	void attachChoiceBox(juce::ComboBox& box, const juce::String& paramID);
 
 	std::vector<juce::Component*> getComps();
 
@@ -9,6 +9,119 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+/*
+ replaces the global operator new/delete family so ScopedAllocationTrap can catch the audio thread using them.
+ malloc and friends are left alone: replacing them means interposing on the host's allocator.
+ even the operators may end up shared with the host on platforms that merge symbols across binaries,
+ which is why this is a debug-only check. outside a trap the replacements behave exactly like the defaults.
+ */
+#ifndef SIMPLEEQ_TRAP_AUDIO_THREAD_ALLOCATIONS
+ #define SIMPLEEQ_TRAP_AUDIO_THREAD_ALLOCATIONS JUCE_DEBUG
+#endif
+
+#if SIMPLEEQ_TRAP_AUDIO_THREAD_ALLOCATIONS
+namespace
+{
+	thread_local bool heapAccessForbidden = false;
+
+	void trapHeapAccess()
+	{
+		if (heapAccessForbidden)
+		{
+			//the assertion/logging machinery may allocate, so let it.
+			heapAccessForbidden = false;
+			DBG("SimpleEQ: heap accessed inside the audio callback!");
+			jassertfalse;
+			heapAccessForbidden = true;
+		}
+	}
+
+	void* tryAllocate(std::size_t size) noexcept
+	{
+		trapHeapAccess();
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	void* allocate(std::size_t size)
+	{
+		if (auto* ptr = tryAllocate(size))
+			return ptr;
+
+		throw std::bad_alloc();
+	}
+
+	void deallocate(void* ptr) noexcept
+	{
+		if (ptr != nullptr)
+			trapHeapAccess();
+
+		std::free(ptr);
+	}
+
+	void* tryAllocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+	{
+		trapHeapAccess();
+
+		auto align = juce::jmax((std::size_t)alignment, sizeof(void*));
+		size = size == 0 ? 1 : size;
+	   #if JUCE_WINDOWS
+		return _aligned_malloc(size, align);
+	   #else
+		void* ptr = nullptr;
+		return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+	   #endif
+	}
+
+	void* allocateAligned(std::size_t size, std::align_val_t alignment)
+	{
+		if (auto* ptr = tryAllocateAligned(size, alignment))
+			return ptr;
+
+		throw std::bad_alloc();
+	}
+
+	void deallocateAligned(void* ptr) noexcept
+	{
+		if (ptr != nullptr)
+			trapHeapAccess();
+
+	   #if JUCE_WINDOWS
+		_aligned_free(ptr);
+	   #else
+		std::free(ptr);
+	   #endif
+	}
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return tryAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return tryAllocate(size); }
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return tryAllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return tryAllocateAligned(size, alignment); }
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocateAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { deallocateAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { deallocateAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { deallocateAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(ptr); }
+
+ScopedAllocationTrap::ScopedAllocationTrap() { heapAccessForbidden = true; }
+ScopedAllocationTrap::~ScopedAllocationTrap() { heapAccessForbidden = false; }
+#else
+ScopedAllocationTrap::ScopedAllocationTrap() {}
+ScopedAllocationTrap::~ScopedAllocationTrap() {}
+#endif
+
 juce::String SimpleEQAudioProcessor::paramPeakFreq("Peak Freq");
 juce::String SimpleEQAudioProcessor::paramPeakGain("Peak Gain");
 juce::String SimpleEQAudioProcessor::paramLowCutFreq( "LowCut Freq");
@@ -20,6 +133,20 @@ juce::String SimpleEQAudioProcessor::paramLowCutBypassed("LowCut Bypassed");
 juce::String SimpleEQAudioProcessor::paramPeakBypassed("Peak Bypassed");
 juce::String SimpleEQAudioProcessor::paramHighCutBypassed("HighCut Bypassed");
 juce::String SimpleEQAudioProcessor::paramAnalyzerEnabled("Analyzer Enabled");
+juce::String SimpleEQAudioProcessor::paramSmoothing("Smoothing");
+juce::String SimpleEQAudioProcessor::paramAnalyzerResolution("Analyzer Resolution");
+juce::String SimpleEQAudioProcessor::paramAnalyzerOverlap("Analyzer Overlap");
+juce::String SimpleEQAudioProcessor::paramAnalyzerAveraging("Analyzer Averaging");
+juce::String SimpleEQAudioProcessor::paramAnalyzerAverageFrames("Analyzer Average Frames");
+juce::String SimpleEQAudioProcessor::paramAnalyzerPeakDecay("Analyzer Peak Decay");
+juce::String SimpleEQAudioProcessor::paramAnalyzerView("Analyzer View");
+juce::String SimpleEQAudioProcessor::paramShowBandCurves("Show Band Curves");
+juce::String SimpleEQAudioProcessor::paramShowPhase("Show Phase");
+juce::String SimpleEQAudioProcessor::paramShowGroupDelay("Show Group Delay");
+juce::String SimpleEQAudioProcessor::paramProcessingMode("Processing Mode");
+juce::String SimpleEQAudioProcessor::paramLinearPhaseLength("Linear Phase Length");
+juce::String SimpleEQAudioProcessor::paramOversampling("Oversampling");
+juce::String SimpleEQAudioProcessor::paramPeakDesign("Peak Design");
 
 
 //==============================================================================
@@ -35,10 +162,15 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
 	)
 #endif
 {
+	analyzerEnabled = apvts.getRawParameterValue(paramAnalyzerEnabled);
+	processingMode = apvts.getRawParameterValue(paramProcessingMode);
+	linearPhaseLength = apvts.getRawParameterValue(paramLinearPhaseLength);
+	oversampling = apvts.getRawParameterValue(paramOversampling);
 }
 
 SimpleEQAudioProcessor::~SimpleEQAudioProcessor()
 {
+	cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -76,6 +208,10 @@ bool SimpleEQAudioProcessor::isMidiEffect() const
 
 double SimpleEQAudioProcessor::getTailLengthSeconds() const
 {
+	//the IIR tails are short enough to ignore, a linear phase kernel rings for its whole length
+	if (isLinearPhaseRunning() && getSampleRate() > 0)
+		return getLinearPhaseNumTaps() / getSampleRate();
+
 	return 0.0;
 }
 
@@ -113,12 +249,53 @@ void SimpleEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
 
 	spec.maximumBlockSize = samplesPerBlock;
 
-	spec.numChannels = 1;
+	spec.sampleRate = sampleRate;
+
+	//pack the channels of the actual bus layout into as few SIMD chains as possible
+	const auto numChannels = (size_t)juce::jmax(1, getTotalNumOutputChannels());
+	const auto lanesPerChain = InterleavedChain::getMaxNumChannels();
+
+	oversamplers.clear();
+
+	//polyphase IIR half band stages: cheap and low latency, the chain is minimum phase anyway
+	for (size_t stages : { 1, 2 })
+	{
+		auto* oversampler = oversamplers.add(new juce::dsp::Oversampling<float>(numChannels, stages,
+			juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true));
+		oversampler->initProcessing((size_t)samplesPerBlock);
+	}
+
+	//room for the 4x block
+	spec.maximumBlockSize = (juce::uint32)samplesPerBlock * 4;
+
+	chainPool.clear();
+
+	for (size_t firstChannel = 0; firstChannel < numChannels; firstChannel += lanesPerChain)
+	{
+		spec.numChannels = (juce::uint32)juce::jmin(lanesPerChain, numChannels - firstChannel);
+
+		auto* chain = chainPool.add(new InterleavedChain());
+		chain->prepare(spec);
+	}
+
+	spec.maximumBlockSize = (juce::uint32)samplesPerBlock;
+	maxBlockSize = (size_t)samplesPerBlock;
+	appliedOversamplingFactor = getOversamplingFactor();
 
-	leftChain.prepare(spec);
-	rightChain.prepare(spec);
+	dspLoadMeter.reset();
 
-	updateFilters();
+	auto chainSettings = getChainSettings(apvts);
+	smoother.reset(sampleRate, 0.05);
+	smoother.snapToTarget(chainSettings);
+	updateFilters(chainSettings, true);
+
+	//the convolutions and their design thread are only built once linear phase is used, see handleAsyncUpdate
+	spec.numChannels = (juce::uint32)numChannels;
+	linearPhaseChain.prepare(spec);
+	if (isLinearPhase())
+		linearPhaseChain.activate(chainSettings, getLinearPhaseNumTaps());
+	linearPhaseWasActive = isLinearPhaseRunning();
+	setLatencySamples(getProcessingLatency());
 
 	leftChannelFifo.prepare(samplesPerBlock);
 	rightChannelFifo.prepare(samplesPerBlock);
@@ -145,12 +322,8 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 	juce::ignoreUnused(layouts);
 	return true;
 #else
-	// This is the place where you check if the layout is supported.
-	// In this template code we only support mono or stereo.
-	// Some plugin hosts, such as certain GarageBand versions, will only
-	// load plugins that support stereo bus layouts.
-	if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-		&& layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+	// Any layout works, the channels are spread over as many InterleavedChains as needed.
+	if (layouts.getMainOutputChannelSet().isDisabled())
 		return false;
 
 	// This checks if the input layout matches the output layout
@@ -166,7 +339,10 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 
 void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+	auto startTicks = juce::Time::getHighResolutionTicks();
+
 	juce::ScopedNoDenormals noDenormals;
+	ScopedAllocationTrap allocationTrap;
 	auto totalNumInputChannels = getTotalNumInputChannels();
 	auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -186,36 +362,175 @@ void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
 	// Alternatively, you can process the samples with the channels
 	// interleaved by keeping the same state.
 
-	updateFilters();
+	auto block = juce::dsp::AudioBlock<float>(buffer)
+		.getSubsetChannelBlock(0, (size_t)juce::jmin(totalNumInputChannels, totalNumOutputChannels));
+
+	auto chainSettings = getChainSettings(apvts);
+	auto stride = getSmoothingStride();
+	bool anyBandUpdated = false;
+
+	auto oversamplingFactor = getOversamplingFactor();
+	if (oversamplingFactor != appliedOversamplingFactor)
+	{
+		applyOversamplingFactor(oversamplingFactor);
+		smoother.snapToTarget(chainSettings);
+		anyBandUpdated = updateFilters(chainSettings, true);
+	}
+
+	auto linearPhase = isLinearPhaseRunning();
+	if (linearPhase && !linearPhaseWasActive)
+	{
+		//whatever the convolutions still hold is from the last time linear phase was on
+		linearPhaseChain.reset();
+	}
+	linearPhaseWasActive = linearPhase;
+
+	if (linearPhase)
+	{
+		//the IIR coefficients are kept current, so switching back doesn't start from stale ones
+		smoother.snapToTarget(chainSettings);
+		anyBandUpdated |= updateFilters(chainSettings);
 
-	juce::dsp::AudioBlock<float> block(buffer);
+		linearPhaseChain.setSettings(chainSettings, getLinearPhaseNumTaps());
+		linearPhaseChain.process(block);
+	}
+	else if (stride == 0)
+	{
+		smoother.snapToTarget(chainSettings);
+		anyBandUpdated |= updateFilters(chainSettings);
+		processChains(block);
+	}
+	else
+	{
+		smoother.setTarget(chainSettings);
 
-	//buffer.clear();
+		const auto numSamples = (int)block.getNumSamples();
+		for (int start = 0; start < numSamples; start += stride)
+		{
+			auto numInSubBlock = juce::jmin(stride, numSamples - start);
 
-	//for (int i = 0; i < buffer.getNumSamples(); i++)
-	//{
-	//	buffer.setSample(0, i, osc.processSample(0));
-	//}
+			anyBandUpdated |= updateFilters(smoother.skip(numInSubBlock));
+			processChains(block.getSubBlock((size_t)start, (size_t)numInSubBlock));
+		}
+	}
 
-	//juce::dsp::ProcessContextReplacing<float> stereoContext(block);
-	//osc.process(stereoContext);
+	if (!anyBandUpdated)
+	{
+		++skippedFilterUpdates;
+	}
 
+	if (getProcessingLatency() != getLatencySamples() || (isLinearPhase() && !linearPhaseChain.isReady()))
+		triggerAsyncUpdate();
 
-	
+	if (analyzerConsumers.get() > 0 && analyzerEnabled->load() > 0.5f)
+	{
+		leftChannelFifo.update(buffer);
+		rightChannelFifo.update(buffer);
+	}
+
+	if (getSampleRate() > 0)
+	{
+		auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+		dspLoadMeter.addBlock(elapsedSeconds, buffer.getNumSamples() / getSampleRate());
+	}
+}
+
+void SimpleEQAudioProcessor::processChains(const juce::dsp::AudioBlock<float>& block)
+{
+	//samplesPerBlock is only a hint, the oversamplers and chains are sized for no more than that
+	const auto numSamples = block.getNumSamples();
+
+	for (size_t start = 0; start < numSamples; start += maxBlockSize)
+	{
+		auto subBlock = block.getSubBlock(start, juce::jmin(maxBlockSize, numSamples - start));
+
+		if (appliedOversamplingFactor == 1)
+		{
+			processChainsAtFilterRate(subBlock);
+			continue;
+		}
+
+		auto& oversampler = *oversamplers.getUnchecked(appliedOversamplingFactor == 2 ? 0 : 1);
+
+		processChainsAtFilterRate(oversampler.processSamplesUp(subBlock));
+		oversampler.processSamplesDown(subBlock);
+	}
+}
+
+void SimpleEQAudioProcessor::processChainsAtFilterRate(const juce::dsp::AudioBlock<float>& block)
+{
+	const auto numChannels = block.getNumChannels();
+	const auto lanesPerChain = InterleavedChain::getMaxNumChannels();
+
+	for (int i = 0; i < chainPool.size(); ++i)
+	{
+		auto firstChannel = (size_t)i * lanesPerChain;
+		if (firstChannel >= numChannels)
+			break;
+
+		auto numChannelsInChain = juce::jmin(lanesPerChain, numChannels - firstChannel);
+		chainPool.getUnchecked(i)->process(block.getSubsetChannelBlock(firstChannel, numChannelsInChain));
+	}
+}
+
+void SimpleEQAudioProcessor::applyOversamplingFactor(int factor)
+{
+	appliedOversamplingFactor = factor;
+
+	//the filter states belong to the old rate
+	for (auto* interleavedChain : chainPool)
+		interleavedChain->chain.reset();
+
+	for (auto* oversampler : oversamplers)
+		oversampler->reset();
+}
+
+int SimpleEQAudioProcessor::getSmoothingStride()
+{
+	static constexpr int strides[] = { 0, 16, 32, 64 };
+
+	auto choice = juce::jlimit(0, 3, (int)apvts.getRawParameterValue(paramSmoothing)->load());
+	return strides[choice];
+}
+
+int SimpleEQAudioProcessor::getLinearPhaseNumTaps() const
+{
+	//"512" ... "8192"
+	auto choice = juce::jlimit(0, 4, (int)linearPhaseLength->load());
+	return 512 << choice;
+}
 
-	auto leftBlock = block.getSingleChannelBlock(0);
-	auto rightBlock = block.getSingleChannelBlock(1);
+int SimpleEQAudioProcessor::getOversamplingFactor() const
+{
+	if (isLinearPhase())
+		return 1;
 
-	juce::dsp::ProcessContextReplacing<float>leftContext(leftBlock);
-	juce::dsp::ProcessContextReplacing<float>rightContext(rightBlock);
+	//"Off", "2x", "4x"
+	return 1 << juce::jlimit(0, 2, (int)oversampling->load());
+}
 
-	leftChain.process(leftContext);
-	rightChain.process(rightContext);
+int SimpleEQAudioProcessor::getProcessingLatency() const
+{
+	if (isLinearPhaseRunning())
+		return LinearPhaseChain::getLatencySamples(getLinearPhaseNumTaps());
 
-	leftChannelFifo.update(buffer);
-	rightChannelFifo.update(buffer);
+	auto factor = getOversamplingFactor();
+	if (factor == 1 || oversamplers.isEmpty())
+		return 0;
 
+	return juce::roundToInt(oversamplers.getUnchecked(factor == 2 ? 0 : 1)->getLatencyInSamples());
+}
 
+void SimpleEQAudioProcessor::handleAsyncUpdate()
+{
+	//the audio thread keeps away from the chain until it is ready, so it can be built while playing
+	if (isLinearPhase() && !linearPhaseChain.isReady())
+		linearPhaseChain.activate(getChainSettings(apvts), getLinearPhaseNumTaps());
+
+	//mode, length and oversampling can change while playing, but hosts want latency changes from the message thread
+	auto latency = getProcessingLatency();
+	if (latency != getLatencySamples())
+		setLatencySamples(latency);
 }
 
 //==============================================================================
@@ -251,8 +566,8 @@ void SimpleEQAudioProcessor::setStateInformation(const void* data, int sizeInByt
 	auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
 	if (tree.isValid())
 	{
+		//the new parameter values are picked up by the dirty check in the next processBlock
 		apvts.replaceState(tree);
-		updateFilters();
 	}
 }
 
@@ -271,6 +586,7 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
 	settings.peakQuality = apvts.getRawParameterValue(SEP::paramPeakQuality)->load();
 	settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue(SEP::paramLowCutSlope)->load());
 	settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue(SEP::paramHighCutSlope)->load());
+	settings.peakDesign = static_cast<PeakDesign>(apvts.getRawParameterValue(SEP::paramPeakDesign)->load());
 
 	//Bypassed
 	settings.lowCutBypassed = apvts.getRawParameterValue(SEP::paramLowCutBypassed)->load() > 0.5f;
@@ -285,6 +601,12 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
 
 Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate)
 {
+	if (chainSettings.peakDesign == PeakDesign::PeakDesign_Matched)
+	{
+		BiquadCoefficients c;
+		designPeakFilter(chainSettings, sampleRate, c);
+		return new juce::dsp::IIR::Coefficients<float>(c[0], c[1], c[2], 1.f, c[3], c[4]);
+	}
 
 	return juce::dsp::IIR::Coefficients<float>::makePeakFilter(
 		sampleRate,
@@ -293,16 +615,117 @@ Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRat
 		juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
 }
 
-void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings)
+static void designMatchedPeakFilter(const ChainSettings& chainSettings, double sampleRate, BiquadCoefficients& dest)
 {
+	/*
+	 M. Vicanek, "Matched Second Order Digital Filters" (2016).
+	 the poles are the impulse invariant ones of the analog prototype
+	 H(s) = (s^2 + s A / Q + 1) / (s^2 + s / (A Q) + 1), A = sqrt(G), the one makePeakFilter warps.
+	 the zeros are then solved so |H|^2 follows the prototype at DC and around the centre frequency,
+	 using the phi = sin^2(w/2) form of multiplyByMagnitudeSquared.
+	 */
+	const auto G = (double)juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels);
+	const auto A = std::sqrt(G);
+
+	//above Nyquist phi wraps around, keep the centre just below it
+	auto freq = juce::jlimit(2.0, 0.49 * sampleRate, double(chainSettings.peakFreq));
+	auto w0 = juce::MathConstants<double>::twoPi * freq / sampleRate;
+	auto q = 1.0 / (2.0 * chainSettings.peakQuality * A);
+
+	auto a1 = q <= 1.0 ? -2.0 * std::exp(-q * w0) * std::cos(std::sqrt(1.0 - q * q) * w0)
+		: -2.0 * std::exp(-q * w0) * std::cosh(std::sqrt(q * q - 1.0) * w0);
+	auto a2 = std::exp(-2.0 * q * w0);
+
+	auto A0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+	auto A1 = (1.0 - a1 + a2) * (1.0 - a1 + a2);
+	auto A2 = -4.0 * a2;
+
+	auto phi1 = std::sin(w0 / 2.0) * std::sin(w0 / 2.0);
+	auto phi0 = 1.0 - phi1;
+	auto phi2 = 4.0 * phi0 * phi1;
+
+	auto R1 = (A0 * phi0 + A1 * phi1 + A2 * phi2) * G * G;
+	auto R2 = (-A0 + A1 + 4.0 * (phi0 - phi1) * A2) * G * G;
+
+	auto B0 = A0;
+	auto B2 = (R1 - R2 * phi1 - B0) / (4.0 * phi1 * phi1);
+	auto B1 = R2 + B0 + 4.0 * (phi1 - phi0) * B2;
+
+	auto sqrtB0 = std::sqrt(B0);
+	auto sqrtB1 = std::sqrt(juce::jmax(0.0, B1));
+	auto W = 0.5 * (sqrtB0 + sqrtB1);
+
+	auto b0 = 0.5 * (W + std::sqrt(juce::jmax(0.0, W * W + B2)));
+	auto b1 = 0.5 * (sqrtB0 - sqrtB1);
+	auto b2 = -B2 / (4.0 * b0);
+
+	dest = { float(b0), float(b1), float(b2), float(a1), float(a2) };
+}
 
-	auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
+void designPeakFilter(const ChainSettings& chainSettings, double sampleRate, BiquadCoefficients& dest)
+{
+	if (chainSettings.peakDesign == PeakDesign::PeakDesign_Matched)
+	{
+		designMatchedPeakFilter(chainSettings, sampleRate, dest);
+		return;
+	}
+
+	//same maths as juce::dsp::IIR::Coefficients<float>::makePeakFilter
+	auto A = std::sqrt(juce::jmax(0.0, (double)juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels)));
+	auto omega = juce::MathConstants<double>::twoPi * juce::jmax(double(chainSettings.peakFreq), 2.0) / sampleRate;
+	auto alpha = std::sin(omega) / (2.0 * chainSettings.peakQuality);
+	auto c2 = -2.0 * std::cos(omega);
+	auto alphaTimesA = alpha * A;
+	auto alphaOverA = alpha / A;
+	auto a0Inverse = 1.0 / (1.0 + alphaOverA);
+
+	dest = { float((1.0 + alphaTimesA) * a0Inverse),
+		float(c2 * a0Inverse),
+		float((1.0 - alphaTimesA) * a0Inverse),
+		float(c2 * a0Inverse),
+		float((1.0 - alphaOverA) * a0Inverse) };
+}
+
+static void designButterworthCut(bool isHighPass, float frequency, Slope slope, double sampleRate, CutCoefficients& dest)
+{
+	//same maths as juce::dsp::FilterDesign<float>::designIIR*HighOrderButterworthMethod for even orders
+	const auto order = (slope + 1) * 2;
+	const auto tanOmega = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+	const auto n = isHighPass ? tanOmega : 1.0 / tanOmega;
+	const auto nSquared = n * n;
+
+	for (int stage = 0; stage <= slope; ++stage)
+	{
+		auto invQ = 2.0 * std::cos((2.0 * stage + 1.0) * juce::MathConstants<double>::pi / (order * 2.0));
+		auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+		auto b1 = isHighPass ? -2.0 * c1 : 2.0 * c1;
+		auto a1 = isHighPass ? c1 * 2.0 * (nSquared - 1.0) : c1 * 2.0 * (1.0 - nSquared);
+
+		dest[stage] = { float(c1), float(b1), float(c1), float(a1), float(c1 * (1.0 - invQ * n + nSquared)) };
+	}
+}
+
+void designLowCutFilter(const ChainSettings& chainSettings, double sampleRate, CutCoefficients& dest)
+{
+	designButterworthCut(true, chainSettings.lowCutFreq, chainSettings.lowCutSlope, sampleRate, dest);
+}
+
+void designHighCutFilter(const ChainSettings& chainSettings, double sampleRate, CutCoefficients& dest)
+{
+	designButterworthCut(false, chainSettings.highCutFreq, chainSettings.highCutSlope, sampleRate, dest);
+}
+
+void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings)
+{
+	designPeakFilter(chainSettings, getSampleRate() * appliedOversamplingFactor, peakCoefficients);
 
-	leftChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-	rightChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+	for (auto* interleavedChain : chainPool)
+	{
+		auto& chain = interleavedChain->chain;
 
-	updateCoefficients(leftChain.get < ChainPositions::Peak>().coefficients, peakCoefficients);
-	updateCoefficients(rightChain.get < ChainPositions::Peak>().coefficients, peakCoefficients);
+		chain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+		updateCoefficients(chain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+	}
 }
 
 void updateCoefficients(Coefficients& old, const Coefficients& replacements)
@@ -310,43 +733,618 @@ void updateCoefficients(Coefficients& old, const Coefficients& replacements)
 	*old = *replacements;
 }
 
-void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+void updateCoefficients(Coefficients& old, const BiquadCoefficients& replacements)
 {
-	auto cutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
+	jassert(old->coefficients.size() == (int)replacements.size());
+	std::copy(replacements.begin(), replacements.end(), old->getRawCoefficients());
+}
 
-	auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-	auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
+void FrequencyResponseGrid::prepare(int numPoints, double minFrequency, double maxFrequency, double newSampleRate)
+{
+	resize(numPoints, newSampleRate);
 
+	for (size_t i = 0; i < (size_t)numPoints; ++i)
+		setFrequency(i, juce::mapToLog10(double(i) / double(numPoints), minFrequency, maxFrequency));
+}
 
-	leftChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-	rightChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
+void FrequencyResponseGrid::prepareLinear(int numPoints, double newSampleRate)
+{
+	jassert(numPoints > 1);
+	resize(numPoints, newSampleRate);
 
-	
-	updateCutFilter(leftLowCut, cutCoefficients, chainSettings.lowCutSlope);
-	updateCutFilter(rightLowCut, cutCoefficients, chainSettings.lowCutSlope);
+	for (size_t i = 0; i < (size_t)numPoints; ++i)
+		setFrequency(i, double(i) * sampleRate / (2.0 * (numPoints - 1)));
+}
+
+void FrequencyResponseGrid::resize(int numPoints, double newSampleRate)
+{
+	sampleRate = newSampleRate;
+	for (auto* v : { &frequencies, &phi, &cosW, &sinW, &cos2W, &sin2W })
+		v->resize((size_t)numPoints);
+}
+
+void FrequencyResponseGrid::setFrequency(size_t i, double freq)
+{
+	auto w = juce::MathConstants<double>::twoPi * freq / sampleRate;
+	auto s = std::sin(w / 2.0);
+
+	frequencies[i] = freq;
+	phi[i] = s * s;
+	cosW[i] = std::cos(w);
+	sinW[i] = std::sin(w);
+	cos2W[i] = std::cos(2.0 * w);
+	sin2W[i] = std::sin(2.0 * w);
+}
+
+BiquadCoefficients getBiquadCoefficients(const juce::dsp::IIR::Coefficients<float>& coefficients)
+{
+	auto* raw = coefficients.coefficients.begin();
+
+	if (coefficients.coefficients.size() == 3)
+		return { raw[0], raw[1], 0.f, raw[2], 0.f };
+
+	jassert(coefficients.coefficients.size() == 5);
+	return { raw[0], raw[1], raw[2], raw[3], raw[4] };
+}
+
+void multiplyByMagnitudeSquared(const FrequencyResponseGrid& grid, const BiquadCoefficients& coefficients, double* magnitudeSquared)
+{
+	/*
+	 |b0 + b1 z^-1 + b2 z^-2|^2 on the unit circle, with phi = sin^2(w/2):
+	 (b0 + b1 + b2)^2 - 4 (b0 b1 + 4 b0 b2 + b1 b2) phi + 16 b0 b2 phi^2
+	 and the same for 1 + a1 z^-1 + a2 z^-2
+	 */
+	const double b0 = coefficients[0], b1 = coefficients[1], b2 = coefficients[2];
+	const double a1 = coefficients[3], a2 = coefficients[4];
+
+	const auto n0 = (b0 + b1 + b2) * (b0 + b1 + b2);
+	const auto n1 = -4.0 * (b0 * b1 + 4.0 * b0 * b2 + b1 * b2);
+	const auto n2 = 16.0 * b0 * b2;
+
+	const auto d0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+	const auto d1 = -4.0 * (a1 + 4.0 * a2 + a1 * a2);
+	const auto d2 = 16.0 * a2;
+
+	const auto* phi = grid.phi.data();
+
+	for (int i = 0; i < grid.getNumPoints(); ++i)
+	{
+		const auto p = phi[i];
+		magnitudeSquared[i] *= (n0 + p * (n1 + p * n2)) / (d0 + p * (d1 + p * d2));
+	}
+}
+
+template<typename CutFilterType>
+static void multiplyByCutMagnitudeSquared(const CutFilterType& cut, const FrequencyResponseGrid& grid, double* magnitudeSquared)
+{
+	if (!cut.template isBypassed<0>())
+		multiplyByMagnitudeSquared(grid, getBiquadCoefficients(*cut.template get<0>().coefficients), magnitudeSquared);
+	if (!cut.template isBypassed<1>())
+		multiplyByMagnitudeSquared(grid, getBiquadCoefficients(*cut.template get<1>().coefficients), magnitudeSquared);
+	if (!cut.template isBypassed<2>())
+		multiplyByMagnitudeSquared(grid, getBiquadCoefficients(*cut.template get<2>().coefficients), magnitudeSquared);
+	if (!cut.template isBypassed<3>())
+		multiplyByMagnitudeSquared(grid, getBiquadCoefficients(*cut.template get<3>().coefficients), magnitudeSquared);
+}
+
+void getChainMagnitudeSquared(const MonoChain& chain, const FrequencyResponseGrid& grid, double* magnitudeSquared)
+{
+	std::fill(magnitudeSquared, magnitudeSquared + grid.getNumPoints(), 1.0);
+
+	if (!chain.isBypassed<ChainPositions::LowCut>())
+		multiplyByCutMagnitudeSquared(chain.get<ChainPositions::LowCut>(), grid, magnitudeSquared);
+
+	if (!chain.isBypassed<ChainPositions::Peak>())
+		multiplyByMagnitudeSquared(grid, getBiquadCoefficients(*chain.get<ChainPositions::Peak>().coefficients), magnitudeSquared);
+
+	if (!chain.isBypassed<ChainPositions::HighCut>())
+		multiplyByCutMagnitudeSquared(chain.get<ChainPositions::HighCut>(), grid, magnitudeSquared);
+}
+
+void ChainResponse::resize(int numPoints)
+{
+	for (auto* c : { &bands[0], &bands[1], &bands[2], &total })
+	{
+		c->re.resize((size_t)numPoints);
+		c->im.resize((size_t)numPoints);
+	}
+
+	groupDelaySamples.resize((size_t)numPoints);
+}
+
+void multiplyByResponse(const FrequencyResponseGrid& grid, const BiquadCoefficients& coefficients,
+	ChainResponse::Complex& response, double* groupDelaySamples)
+{
+	const double b0 = coefficients[0], b1 = coefficients[1], b2 = coefficients[2];
+	const double a1 = coefficients[3], a2 = coefficients[4];
+
+	auto* re = response.re.data();
+	auto* im = response.im.data();
+
+	for (size_t i = 0; i < (size_t)grid.getNumPoints(); ++i)
+	{
+		const auto c1 = grid.cosW[i], s1 = grid.sinW[i], c2 = grid.cos2W[i], s2 = grid.sin2W[i];
+
+		//N = b0 + b1 e^-jw + b2 e^-2jw, D = 1 + a1 e^-jw + a2 e^-2jw, and their k-weighted sums
+		const auto nRe = b0 + b1 * c1 + b2 * c2, nIm = -(b1 * s1 + b2 * s2);
+		const auto dRe = 1.0 + a1 * c1 + a2 * c2, dIm = -(a1 * s1 + a2 * s2);
+		const auto knRe = b1 * c1 + 2.0 * b2 * c2, knIm = -(b1 * s1 + 2.0 * b2 * s2);
+		const auto kdRe = a1 * c1 + 2.0 * a2 * c2, kdIm = -(a1 * s1 + 2.0 * a2 * s2);
+
+		const auto nMag = std::max(nRe * nRe + nIm * nIm, 1.0e-300);
+		const auto dMag = std::max(dRe * dRe + dIm * dIm, 1.0e-300);
+
+		//H = N conj(D) / |D|^2
+		const auto hRe = (nRe * dRe + nIm * dIm) / dMag;
+		const auto hIm = (nIm * dRe - nRe * dIm) / dMag;
+
+		const auto r = re[i] * hRe - im[i] * hIm;
+		im[i] = re[i] * hIm + im[i] * hRe;
+		re[i] = r;
+
+		groupDelaySamples[i] += (knRe * nRe + knIm * nIm) / nMag - (kdRe * dRe + kdIm * dIm) / dMag;
+	}
+}
+
+template<typename CutFilterType>
+static void multiplyByCutResponse(const CutFilterType& cut, const FrequencyResponseGrid& grid,
+	ChainResponse::Complex& response, double* groupDelaySamples)
+{
+	if (!cut.template isBypassed<0>())
+		multiplyByResponse(grid, getBiquadCoefficients(*cut.template get<0>().coefficients), response, groupDelaySamples);
+	if (!cut.template isBypassed<1>())
+		multiplyByResponse(grid, getBiquadCoefficients(*cut.template get<1>().coefficients), response, groupDelaySamples);
+	if (!cut.template isBypassed<2>())
+		multiplyByResponse(grid, getBiquadCoefficients(*cut.template get<2>().coefficients), response, groupDelaySamples);
+	if (!cut.template isBypassed<3>())
+		multiplyByResponse(grid, getBiquadCoefficients(*cut.template get<3>().coefficients), response, groupDelaySamples);
+}
+
+void getChainResponse(const MonoChain& chain, const FrequencyResponseGrid& grid, ChainResponse& dest)
+{
+	const auto numPoints = (size_t)grid.getNumPoints();
+	dest.resize(grid.getNumPoints());
+
+	for (auto& band : dest.bands)
+	{
+		std::fill(band.re.begin(), band.re.end(), 1.0);
+		std::fill(band.im.begin(), band.im.end(), 0.0);
+	}
+
+	std::fill(dest.groupDelaySamples.begin(), dest.groupDelaySamples.end(), 0.0);
+
+	auto* groupDelay = dest.groupDelaySamples.data();
+
+	if (!chain.isBypassed<ChainPositions::LowCut>())
+		multiplyByCutResponse(chain.get<ChainPositions::LowCut>(), grid, dest.bands[ChainPositions::LowCut], groupDelay);
+
+	if (!chain.isBypassed<ChainPositions::Peak>())
+		multiplyByResponse(grid, getBiquadCoefficients(*chain.get<ChainPositions::Peak>().coefficients),
+			dest.bands[ChainPositions::Peak], groupDelay);
+
+	if (!chain.isBypassed<ChainPositions::HighCut>())
+		multiplyByCutResponse(chain.get<ChainPositions::HighCut>(), grid, dest.bands[ChainPositions::HighCut], groupDelay);
+
+	//total = LowCut * Peak * HighCut
+	auto& low = dest.bands[ChainPositions::LowCut];
+	auto& peak = dest.bands[ChainPositions::Peak];
+	auto& high = dest.bands[ChainPositions::HighCut];
+
+	for (size_t i = 0; i < numPoints; ++i)
+	{
+		const auto re = low.re[i] * peak.re[i] - low.im[i] * peak.im[i];
+		const auto im = low.re[i] * peak.im[i] + low.im[i] * peak.re[i];
+
+		dest.total.re[i] = re * high.re[i] - im * high.im[i];
+		dest.total.im[i] = re * high.im[i] + im * high.re[i];
+	}
+}
+
+void InterleavedChain::prepare(const juce::dsp::ProcessSpec& spec)
+{
+	jassert(spec.numChannels <= getMaxNumChannels());
+
+	//unused lanes are never written, so they stay silent
+	interleaved = juce::dsp::AudioBlock<SIMDFloat>(interleavedData, 1, spec.maximumBlockSize);
+	interleaved.clear();
+
+	//give every filter a biquad to write into, so updating never allocates on the audio thread
+	prepareCoefficientStorage(chain);
+
+	auto laneSpec = spec;
+	laneSpec.numChannels = 1;
+	chain.prepare(laneSpec);
+}
+
+void InterleavedChain::process(const juce::dsp::AudioBlock<float>& block)
+{
+	const auto numChannels = block.getNumChannels();
+	const auto numLanes = SIMDFloat::size();
+
+	jassert(numChannels <= numLanes);
+
+	auto* lanes = reinterpret_cast<float*>(interleaved.getChannelPointer(0));
+
+	//the interleave buffer only holds the prepared block size, longer blocks go through it in pieces
+	for (size_t start = 0; start < block.getNumSamples(); start += interleaved.getNumSamples())
+	{
+		const auto numSamples = juce::jmin(interleaved.getNumSamples(), block.getNumSamples() - start);
+
+		for (size_t ch = 0; ch < numChannels; ++ch)
+		{
+			auto* src = block.getChannelPointer(ch) + start;
+
+			for (size_t i = 0; i < numSamples; ++i)
+				lanes[i * numLanes + ch] = src[i];
+		}
+
+		auto laneBlock = interleaved.getSubBlock(0, numSamples);
+		juce::dsp::ProcessContextReplacing<SIMDFloat> context(laneBlock);
+		chain.process(context);
+
+		for (size_t ch = 0; ch < numChannels; ++ch)
+		{
+			auto* dest = block.getChannelPointer(ch) + start;
+
+			for (size_t i = 0; i < numSamples; ++i)
+				dest[i] = lanes[i * numLanes + ch];
+		}
+	}
+}
+
+LinearPhaseChain::LinearPhaseChain() : juce::Thread("SimpleEQ Linear Phase")
+{
+}
+
+LinearPhaseChain::~LinearPhaseChain()
+{
+	stopThread(2000);
+}
+
+void LinearPhaseChain::prepare(const juce::dsp::ProcessSpec& newSpec)
+{
+	stopThread(2000);
+
+	ready = false;
+	spec = newSpec;
+	convolutions.clear();
+}
+
+void LinearPhaseChain::activate(const ChainSettings& chainSettings, int numTaps)
+{
+	jassert(!ready.get());
+
+	for (juce::uint32 firstChannel = 0; firstChannel < spec.numChannels; firstChannel += 2)
+		convolutions.add(new juce::dsp::Convolution(juce::dsp::Convolution::Latency{ 0 }, messageQueue));
+
+	//loading before prepare() makes the convolutions pick the kernel up synchronously
+	loadKernel(chainSettings, numTaps);
+
+	for (int i = 0; i < convolutions.size(); ++i)
+	{
+		auto pairSpec = spec;
+		pairSpec.numChannels = juce::jmin(2u, spec.numChannels - (juce::uint32)i * 2);
+		convolutions.getUnchecked(i)->prepare(pairSpec);
+	}
+
+	postedSettings = chainSettings;
+	postedNumTaps = numTaps;
+	hasRequest = false;
+
+	startThread();
+	ready = true;
+}
+
+void LinearPhaseChain::setSettings(const ChainSettings& chainSettings, int numTaps)
+{
+	if (numTaps == postedNumTaps
+		&& !lowCutSettingsChanged(chainSettings, postedSettings)
+		&& !peakSettingsChanged(chainSettings, postedSettings)
+		&& !highCutSettingsChanged(chainSettings, postedSettings))
+		return;
+
+	//if run() is busy picking up the last request, try again next block
+	const juce::SpinLock::ScopedTryLockType lock(requestLock);
+	if (!lock.isLocked())
+		return;
+
+	requestedSettings = chainSettings;
+	requestedNumTaps = numTaps;
+	hasRequest = true;
+
+	postedSettings = chainSettings;
+	postedNumTaps = numTaps;
+
+	notify();
+}
+
+void LinearPhaseChain::reset()
+{
+	for (auto* convolution : convolutions)
+		convolution->reset();
+}
+
+void LinearPhaseChain::process(const juce::dsp::AudioBlock<float>& block)
+{
+	const auto numChannels = block.getNumChannels();
+	const auto numSamples = block.getNumSamples();
+	const auto maxBlockSize = (size_t)spec.maximumBlockSize;
+
+	//the convolutions' dry/wet buffers are sized for spec.maximumBlockSize
+	for (size_t start = 0; start < numSamples; start += maxBlockSize)
+	{
+		auto subBlock = block.getSubBlock(start, juce::jmin(maxBlockSize, numSamples - start));
+
+		for (int i = 0; i < convolutions.size(); ++i)
+		{
+			auto firstChannel = (size_t)i * 2;
+			if (firstChannel >= numChannels)
+				break;
+
+			auto pair = subBlock.getSubsetChannelBlock(firstChannel, juce::jmin((size_t)2, numChannels - firstChannel));
+			juce::dsp::ProcessContextReplacing<float> context(pair);
+			convolutions.getUnchecked(i)->process(context);
+		}
+	}
+}
+
+void LinearPhaseChain::run()
+{
+	//sleeps until setSettings() posts a request. requests posted during a design overwrite each other,
+	//so a parameter drag costs one design per design time, not one per block
+	while (!threadShouldExit())
+	{
+		ChainSettings settings;
+		int numTaps = 0;
+		bool designNow = false;
+
+		{
+			const juce::SpinLock::ScopedLockType lock(requestLock);
+			if (hasRequest)
+			{
+				settings = requestedSettings;
+				numTaps = requestedNumTaps;
+				hasRequest = false;
+				designNow = true;
+			}
+		}
+
+		if (designNow)
+			loadKernel(settings, numTaps);
+
+		wait(-1);
+	}
+}
+
+void LinearPhaseChain::loadKernel(const ChainSettings& chainSettings, int numTaps)
+{
+	juce::AudioBuffer<float> kernel;
+	designKernel(chainSettings, spec.sampleRate, numTaps, kernel);
+
+	//no trimming or normalising, both would move the centre tap away from the reported latency
+	for (auto* convolution : convolutions)
+	{
+		convolution->loadImpulseResponse(juce::AudioBuffer<float>(kernel), spec.sampleRate,
+			juce::dsp::Convolution::Stereo::no,
+			juce::dsp::Convolution::Trim::no,
+			juce::dsp::Convolution::Normalise::no);
+	}
+}
+
+void LinearPhaseChain::designKernel(const ChainSettings& chainSettings, double sampleRate, int numTaps, juce::AudioBuffer<float>& dest)
+{
+	jassert(juce::isPowerOfTwo(numTaps));
+
+	//the same biquads the minimum phase path runs
+	MonoChain chain;
+	prepareCoefficientStorage(chain);
+
+	CutCoefficients lowCut, highCut;
+	BiquadCoefficients peak;
+	designLowCutFilter(chainSettings, sampleRate, lowCut);
+	designPeakFilter(chainSettings, sampleRate, peak);
+	designHighCutFilter(chainSettings, sampleRate, highCut);
+
+	updateCutFilter(chain.get<ChainPositions::LowCut>(), lowCut, chainSettings.lowCutSlope);
+	updateCoefficients(chain.get<ChainPositions::Peak>().coefficients, peak);
+	updateCutFilter(chain.get<ChainPositions::HighCut>(), highCut, chainSettings.highCutSlope);
+
+	chain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
+	chain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+	chain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+
+	//|H| at the bins of a numTaps point FFT
+	const auto numBins = numTaps / 2 + 1;
+	FrequencyResponseGrid grid;
+	grid.prepareLinear(numBins, sampleRate);
+
+	std::vector<double> magnitudeSquared((size_t)numBins);
+	getChainMagnitudeSquared(chain, grid, magnitudeSquared.data());
+
+	/*
+	 a real (zero phase) spectrum transforms to an impulse that is symmetric around sample 0.
+	 both halves of the spectrum are filled in, so it doesn't matter whether the FFT engine mirrors the upper one itself.
+	 */
+	std::vector<float> data((size_t)numTaps * 2, 0.f);
+	double targetEnergy = 0.0;
+
+	for (int k = 0; k < numTaps; ++k)
+	{
+		auto bin = (size_t)(k < numBins ? k : numTaps - k);
+		data[(size_t)k * 2] = (float)std::sqrt(magnitudeSquared[bin]);
+		targetEnergy += magnitudeSquared[bin];
+	}
+
+	juce::dsp::FFT fft(juce::roundToInt(std::log2((double)numTaps)));
+	fft.performRealOnlyInverseTransform(data.data());
+
+	//scale by Parseval (sum h^2 = sum |H|^2 / N) rather than relying on the engine's inverse scaling
+	double energy = 0.0;
+	for (int n = 0; n < numTaps; ++n)
+		energy += (double)data[(size_t)n] * data[(size_t)n];
+
+	auto scale = energy > 0.0 ? std::sqrt(targetEnergy / numTaps / energy) : 0.0;
+
+	//centre it on numTaps / 2 and window it. sample 0 has no partner, dropping it keeps the kernel symmetric
+	dest.setSize(1, numTaps, false, false, true);
+	auto* kernel = dest.getWritePointer(0);
+	kernel[0] = 0.f;
+
+	for (int n = 1; n < numTaps; ++n)
+	{
+		auto x = juce::MathConstants<double>::twoPi * n / numTaps;
+		auto blackman = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+
+		kernel[n] = float(data[(size_t)((n + numTaps / 2) % numTaps)] * scale * blackman);
+	}
+}
+
+void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+{
+	designLowCutFilter(chainSettings, getSampleRate() * appliedOversamplingFactor, lowCutCoefficients);
+
+	for (auto* interleavedChain : chainPool)
+	{
+		auto& chain = interleavedChain->chain;
+
+		chain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
+		updateCutFilter(chain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
+	}
 }
 
 void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
 {
-	auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
+	designHighCutFilter(chainSettings, getSampleRate() * appliedOversamplingFactor, highCutCoefficients);
 
-	auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-	auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
+	for (auto* interleavedChain : chainPool)
+	{
+		auto& chain = interleavedChain->chain;
 
-	leftChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-	rightChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+		chain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+		updateCutFilter(chain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+	}
+}
+
+bool SimpleEQAudioProcessor::updateFilters(const ChainSettings& chainSettings, bool forceUpdate)
+{
+	bool anyBandUpdated = false;
+
+	if (forceUpdate || lowCutSettingsChanged(chainSettings, appliedSettings))
+	{
+		updateLowCutFilters(chainSettings);
+		anyBandUpdated = true;
+	}
+
+	if (forceUpdate || peakSettingsChanged(chainSettings, appliedSettings))
+	{
+		updatePeakFilter(chainSettings);
+		anyBandUpdated = true;
+	}
 
-	updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-	updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+	if (forceUpdate || highCutSettingsChanged(chainSettings, appliedSettings))
+	{
+		updateHighCutFilters(chainSettings);
+		anyBandUpdated = true;
+	}
+
+	appliedSettings = chainSettings;
+
+	return anyBandUpdated;
+}
+
+void ChainSettingsSmoother::reset(double sampleRate, double rampLengthSeconds)
+{
+	lowCutFreq.reset(sampleRate, rampLengthSeconds);
+	highCutFreq.reset(sampleRate, rampLengthSeconds);
+	peakFreq.reset(sampleRate, rampLengthSeconds);
+	peakQuality.reset(sampleRate, rampLengthSeconds);
+	peakGainInDecibels.reset(sampleRate, rampLengthSeconds);
+}
+
+void ChainSettingsSmoother::setTarget(const ChainSettings& newTarget)
+{
+	target = newTarget;
+
+	lowCutFreq.setTargetValue(target.lowCutFreq);
+	highCutFreq.setTargetValue(target.highCutFreq);
+	peakFreq.setTargetValue(target.peakFreq);
+	peakQuality.setTargetValue(target.peakQuality);
+	peakGainInDecibels.setTargetValue(target.peakGainInDecibels);
+}
+
+void ChainSettingsSmoother::snapToTarget(const ChainSettings& newTarget)
+{
+	target = newTarget;
+
+	lowCutFreq.setCurrentAndTargetValue(target.lowCutFreq);
+	highCutFreq.setCurrentAndTargetValue(target.highCutFreq);
+	peakFreq.setCurrentAndTargetValue(target.peakFreq);
+	peakQuality.setCurrentAndTargetValue(target.peakQuality);
+	peakGainInDecibels.setCurrentAndTargetValue(target.peakGainInDecibels);
+}
+
+ChainSettings ChainSettingsSmoother::skip(int numSamples)
+{
+	auto settings = target;
+
+	settings.lowCutFreq = lowCutFreq.skip(numSamples);
+	settings.highCutFreq = highCutFreq.skip(numSamples);
+	settings.peakFreq = peakFreq.skip(numSamples);
+	settings.peakQuality = peakQuality.skip(numSamples);
+	settings.peakGainInDecibels = peakGainInDecibels.skip(numSamples);
+
+	return settings;
 }
 
-void SimpleEQAudioProcessor::updateFilters()
+void DspLoadMeter::reset()
 {
-	auto& chainSettings = getChainSettings(apvts);
+	for (auto& bucket : histogram)
+		bucket.set(0);
 
-	updateLowCutFilters(chainSettings);
-	updatePeakFilter(chainSettings);
-	updateHighCutFilters(chainSettings);
+	numBlocks.set(0);
+	numOverruns.set(0);
+	lastLoad.set(0.f);
+	maxLoad.set(0.f);
+}
+
+void DspLoadMeter::addBlock(double elapsedSeconds, double budgetSeconds)
+{
+	if (budgetSeconds <= 0.0)
+		return;
+
+	auto load = float(elapsedSeconds / budgetSeconds);
+	auto bucket = juce::jlimit(0, numBuckets - 1, (int)(load / bucketWidth));
+
+	++histogram[(size_t)bucket];
+	++numBlocks;
+
+	if (load > 1.f)
+		++numOverruns;
+
+	lastLoad.set(load);
+
+	//only the audio thread writes, so a plain compare is enough
+	if (load > maxLoad.get())
+		maxLoad.set(load);
+}
+
+float DspLoadMeter::getPercentile(float percentile) const
+{
+	auto total = numBlocks.get();
+	if (total == 0)
+		return 0.f;
+
+	auto target = (juce::int64)std::ceil(total * juce::jlimit(0.f, 100.f, percentile) / 100.f);
+	juce::int64 count = 0;
+
+	for (int bucket = 0; bucket < numBuckets; ++bucket)
+	{
+		count += histogram[(size_t)bucket].get();
+		if (count >= target)
+			return (bucket + 1) * bucketWidth;
+	}
+
+	return numBuckets * bucketWidth;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SimpleEQAudioProcessor::createParameterLayout()
@@ -400,6 +1398,50 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleEQAudioProcessor::crea
 	layout.add(std::make_unique<juce::AudioParameterBool>(paramHighCutBypassed, paramHighCutBypassed, false));
 	layout.add(std::make_unique<juce::AudioParameterBool>(paramAnalyzerEnabled, paramAnalyzerEnabled, true));
 
+	//Coefficient smoothing, the choices are the redesign stride in samples
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramSmoothing, paramSmoothing,
+		juce::StringArray{ "Off", "16 Samples", "32 Samples", "64 Samples" }, 0));
+
+	//Analyzer FFT size, the choices map onto FFTOrder in the editor
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramAnalyzerResolution, paramAnalyzerResolution,
+		juce::StringArray{ "2048", "4096", "8192" }, 0));
+
+	//how much consecutive analyzer frames overlap, the choices map onto AnalyzerOverlap in the editor
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramAnalyzerOverlap, paramAnalyzerOverlap,
+		juce::StringArray{ "25%", "50%", "75%" }, 1));
+
+	//Analyzer smoothing, the choices map onto AnalyzerAveraging in the editor
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramAnalyzerAveraging, paramAnalyzerAveraging,
+		juce::StringArray{ "Off", "Exponential", "Moving Average", "Peak Hold" }, 0));
+	layout.add(std::make_unique<juce::AudioParameterInt>(paramAnalyzerAverageFrames, paramAnalyzerAverageFrames, 2, 32, 8));
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		paramAnalyzerPeakDecay,
+		paramAnalyzerPeakDecay,
+		juce::NormalisableRange<float>(0.f, 60.f, 0.5f, 1.f), 12.f));
+
+	//line spectrum or scrolling spectrogram
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramAnalyzerView, paramAnalyzerView,
+		juce::StringArray{ "Spectrum", "Spectrogram" }, 0));
+
+	//response curve overlays
+	layout.add(std::make_unique<juce::AudioParameterBool>(paramShowBandCurves, paramShowBandCurves, false));
+	layout.add(std::make_unique<juce::AudioParameterBool>(paramShowPhase, paramShowPhase, false));
+	layout.add(std::make_unique<juce::AudioParameterBool>(paramShowGroupDelay, paramShowGroupDelay, false));
+
+	//linear phase runs the same bands as one FIR kernel, the length sets its accuracy in the lows and its latency
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramProcessingMode, paramProcessingMode,
+		juce::StringArray{ "Minimum Phase", "Linear Phase" }, 0));
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramLinearPhaseLength, paramLinearPhaseLength,
+		juce::StringArray{ "512", "1024", "2048", "4096", "8192" }, 3));
+
+	//runs the IIR chain at 2x or 4x the host rate, so the peak and high cut keep their analog shape near Nyquist
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramOversampling, paramOversampling,
+		juce::StringArray{ "Off", "2x", "4x" }, 0));
+
+	//the choices map onto PeakDesign. matched costs the same per sample, only the coefficients differ
+	layout.add(std::make_unique<juce::AudioParameterChoice>(paramPeakDesign, paramPeakDesign,
+		juce::StringArray{ "Bilinear", "Matched" }, 0));
+
 	return layout;
 
 }
@@ -52,6 +52,23 @@ struct Fifo
 		return false;
 	}
 
+	//pushes only the first numElements, the buffers keep the capacity they were prepared with
+	bool push(const float* data, int numElements)
+	{
+		static_assert(std::is_same_v<T, std::vector<float>>,
+			"push(data, numElements) should only be used when the Fifo is holding std::vector<float>");
+		auto write = fifo.write(1);
+		if (write.blockSize1 > 0)
+		{
+			auto& buffer = buffers[write.startIndex1];
+			jassert((size_t)numElements <= buffer.capacity());
+			buffer.assign(data, data + numElements);
+			return true;
+		}
+
+		return false;
+	}
+
 	bool pull(T& t)
 	{
 		auto read = fifo.read(1);
@@ -81,6 +98,83 @@ enum Channel
 	Left // effectively 1
 };
 
+/*
+ lock-free single-producer/single-consumer ring of raw float samples.
+ writes are bulk copies, and the consumer reads through views that point straight into the ring.
+ when the producer outruns the consumer, the samples that don't fit are dropped and counted.
+ */
+struct SampleRing
+{
+	//not thread safe, call before the producer and consumer start
+	void prepare(int capacity)
+	{
+		//AbstractFifo keeps one slot free, so it needs (and uses) capacity + 1 physical slots
+		storage.allocate((size_t)capacity + 1, true);
+		fifo.setTotalSize(capacity + 1);
+		droppedSamples.set(0);
+	}
+
+	//producer
+	void write(const float* samples, int numSamples)
+	{
+		int start1, size1, start2, size2;
+		fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+		if (size1 > 0)
+			juce::FloatVectorOperations::copy(storage.get() + start1, samples, size1);
+		if (size2 > 0)
+			juce::FloatVectorOperations::copy(storage.get() + start2, samples + size1, size2);
+
+		fifo.finishedWrite(size1 + size2);
+
+		if (auto numDropped = numSamples - (size1 + size2); numDropped > 0)
+			droppedSamples += numDropped;
+	}
+
+	/*
+	 a region of the ring ready to be read. it may wrap around, so it is made of two parts.
+	 the region stays valid until the consumer calls finishRead().
+	 */
+	struct ReadView
+	{
+		const float* data1 = nullptr;
+		int size1 = 0;
+		const float* data2 = nullptr;
+		int size2 = 0;
+
+		int getNumSamples() const { return size1 + size2; }
+
+		void copyTo(float* dest) const
+		{
+			if (size1 > 0)
+				juce::FloatVectorOperations::copy(dest, data1, size1);
+			if (size2 > 0)
+				juce::FloatVectorOperations::copy(dest + size1, data2, size2);
+		}
+	};
+
+	//consumer
+	ReadView beginRead(int numWanted) const
+	{
+		int start1, size1, start2, size2;
+		fifo.prepareToRead(numWanted, start1, size1, start2, size2);
+
+		return { storage.get() + start1, size1, storage.get() + start2, size2 };
+	}
+
+	void finishRead(int numRead) { fifo.finishedRead(numRead); }
+
+	//consumer: throws away up to numToDiscard of the oldest samples
+	void discard(int numToDiscard) { finishRead(beginRead(numToDiscard).getNumSamples()); }
+
+	int getNumReady() const { return fifo.getNumReady(); }
+	juce::int64 getNumDroppedSamples() const { return droppedSamples.get(); }
+private:
+	juce::HeapBlock<float> storage;
+	juce::AbstractFifo fifo{ 1 };
+	juce::Atomic<juce::int64> droppedSamples = 0;
+};
+
 template<typename BlockType>
 struct SingleChannelSampleFifo
 {
@@ -92,57 +186,46 @@ struct SingleChannelSampleFifo
 	void update(const BlockType& buffer)
 	{
 		jassert(prepared.get());
-		jassert(buffer.getNumChannels() > channelToUse);
-		auto* channelPtr = buffer.getReadPointer(channelToUse);
+		jassert(buffer.getNumChannels() > 0);
+		//mono layouts feed both analyzer channels from channel 0
+		auto* channelPtr = buffer.getReadPointer(juce::jmin((int)channelToUse, buffer.getNumChannels() - 1));
 
-		for (int i = 0; i < buffer.getNumSamples(); ++i)
-		{
-			pushNextSampleIntoFifo(channelPtr[i]);
-		}
+		ring.write(channelPtr, buffer.getNumSamples());
 	}
 
+	//hosts can call this while a consumer is reading, see getConsumerLock
 	void prepare(int bufferSize)
 	{
+		const juce::SpinLock::ScopedLockType lock(consumerLock);
+
 		prepared.set(false);
 		size.set(bufferSize);
 
-		bufferToFill.setSize(1,             //channel
-			bufferSize,    //num samples
-			false,         //keepExistingContent
-			true,          //clear extra space
-			true);         //avoid reallocating
-		audioBufferFifo.prepare(1, bufferSize);
-		fifoIndex = 0;
+		//room for at least 30 host blocks, and never less than the largest analyzer FFT
+		ring.prepare(juce::jmax(bufferSize * 30, 1 << 15));
 		prepared.set(true);
 	}
+
+	/*
+	 prepare() reallocates the ring. the consumer holds this lock (as a try-lock, skipping
+	 its turn when it fails) from the isPrepared() check until it is done with the ring.
+	 */
+	juce::SpinLock& getConsumerLock() { return consumerLock; }
 	//==============================================================================
-	int getNumCompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
+	int getNumSamplesAvailable() const { return ring.getNumReady(); }
 	bool isPrepared() const { return prepared.get(); }
 	int getSize() const { return size.get(); }
+	juce::int64 getNumDroppedSamples() const { return ring.getNumDroppedSamples(); }
 	//==============================================================================
-	bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+	SampleRing::ReadView beginRead(int numWanted) const { return ring.beginRead(numWanted); }
+	void finishRead(int numRead) { ring.finishRead(numRead); }
+	void discard(int numToDiscard) { ring.discard(numToDiscard); }
 private:
 	Channel channelToUse;
-	int fifoIndex = 0;
-	Fifo<BlockType> audioBufferFifo;
-	BlockType bufferToFill;
+	SampleRing ring;
+	juce::SpinLock consumerLock;
 	juce::Atomic<bool> prepared = false;
 	juce::Atomic<int> size = 0;
-
-	void pushNextSampleIntoFifo(float sample)
-	{
-		if (fifoIndex == bufferToFill.getNumSamples())
-		{
-			auto ok = audioBufferFifo.push(bufferToFill);
-
-			juce::ignoreUnused(ok);
-
-			fifoIndex = 0;
-		}
-
-		bufferToFill.setSample(0, fifoIndex, sample);
-		++fifoIndex;
-	}
 };
 
 enum Slope
@@ -153,14 +236,46 @@ enum Slope
 	Slope_48
 
 };
+
+enum PeakDesign
+{
+	PeakDesign_Bilinear, //RBJ cookbook, cramped towards Nyquist
+	PeakDesign_Matched   //magnitude matched to the analog prototype up to Nyquist (Vicanek)
+};
+
 struct ChainSettings
 {
 	float peakFreq{ 0.0f }, peakGainInDecibels{ 0.0f }, peakQuality{ 1.f };
 	float lowCutFreq{ 0.0f }, highCutFreq{ 0.0f };
 	Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
+	PeakDesign peakDesign{ PeakDesign::PeakDesign_Bilinear };
 	bool lowCutBypassed{ false }, peakBypassed{ false }, highCutBypassed{ false };
 };
 
+//each band is only redesigned when one of its own inputs differs from the last applied snapshot
+inline bool lowCutSettingsChanged(const ChainSettings& current, const ChainSettings& applied)
+{
+	return current.lowCutFreq != applied.lowCutFreq
+		|| current.lowCutSlope != applied.lowCutSlope
+		|| current.lowCutBypassed != applied.lowCutBypassed;
+}
+
+inline bool peakSettingsChanged(const ChainSettings& current, const ChainSettings& applied)
+{
+	return current.peakFreq != applied.peakFreq
+		|| current.peakGainInDecibels != applied.peakGainInDecibels
+		|| current.peakQuality != applied.peakQuality
+		|| current.peakDesign != applied.peakDesign
+		|| current.peakBypassed != applied.peakBypassed;
+}
+
+inline bool highCutSettingsChanged(const ChainSettings& current, const ChainSettings& applied)
+{
+	return current.highCutFreq != applied.highCutFreq
+		|| current.highCutSlope != applied.highCutSlope
+		|| current.highCutBypassed != applied.highCutBypassed;
+}
+
 
 using Filter = juce::dsp::IIR::Filter<float>;
 using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
@@ -178,6 +293,54 @@ void updateCoefficients(Coefficients& old, const Coefficients& replacements);
 
 Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
 
+//raw biquad coefficients in the layout juce::dsp::IIR::Coefficients stores them: b0, b1, b2, a1, a2 (normalised by a0)
+using BiquadCoefficients = std::array<float, 5>;
+using CutCoefficients = std::array<BiquadCoefficients, 4>;
+
+/*
+ allocation-free versions of makePeakFilter/makeLowCutFilter/makeHighCutFilter.
+ they write into storage owned by the caller so they are safe to call from the audio thread.
+ the cut filters only write the stages needed for the requested slope.
+ both peak functions follow chainSettings.peakDesign.
+ */
+void designPeakFilter(const ChainSettings& chainSettings, double sampleRate, BiquadCoefficients& dest);
+void designLowCutFilter(const ChainSettings& chainSettings, double sampleRate, CutCoefficients& dest);
+void designHighCutFilter(const ChainSettings& chainSettings, double sampleRate, CutCoefficients& dest);
+
+//copies in place, 'old' must already hold a biquad (see prepareCoefficientStorage)
+void updateCoefficients(Coefficients& old, const BiquadCoefficients& replacements);
+
+template<typename ChainType>
+void prepareCoefficientStorage(ChainType& chain)
+{
+	auto makeStorage = []() { return new juce::dsp::IIR::Coefficients<float>(1.f, 0.f, 0.f, 1.f, 0.f, 0.f); };
+
+	auto prepareCut = [&makeStorage](auto& cut)
+	{
+		cut.template get<0>().coefficients = makeStorage();
+		cut.template get<1>().coefficients = makeStorage();
+		cut.template get<2>().coefficients = makeStorage();
+		cut.template get<3>().coefficients = makeStorage();
+	};
+
+	prepareCut(chain.template get<ChainPositions::LowCut>());
+	chain.template get<ChainPositions::Peak>().coefficients = makeStorage();
+	prepareCut(chain.template get<ChainPositions::HighCut>());
+}
+
+/*
+ debug builds fail loudly if the current thread uses C++ new or delete (any overload) while one of these is alive.
+ allocations that go straight to malloc/calloc/realloc, such as juce::HeapBlock's, are not caught.
+ see SIMPLEEQ_TRAP_AUDIO_THREAD_ALLOCATIONS in PluginProcessor.cpp
+ */
+struct ScopedAllocationTrap
+{
+	ScopedAllocationTrap();
+	~ScopedAllocationTrap();
+
+	JUCE_DECLARE_NON_COPYABLE(ScopedAllocationTrap)
+};
+
 template<int Index, typename ChainType, typename CoefficientType>
 void update(ChainType& chain, const CoefficientType& coefficients)
 {
@@ -232,11 +395,204 @@ inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleR
 		(chainSettings.highCutSlope + 1) * 2);
 }
 
+/*
+ log spaced frequencies for evaluating filter responses in bulk, e.g. one per pixel column.
+ only depends on the number of points and the sample rate, so it is rebuilt on resize, not per evaluation.
+ */
+struct FrequencyResponseGrid
+{
+	void prepare(int numPoints, double minFrequency, double maxFrequency, double sampleRate);
+
+	//numPoints evenly spaced frequencies from 0 to Nyquist, i.e. the bins of a (numPoints - 1) * 2 point FFT
+	void prepareLinear(int numPoints, double sampleRate);
+
+	int getNumPoints() const { return (int)frequencies.size(); }
+	double getSampleRate() const { return sampleRate; }
+
+	std::vector<double> frequencies;
+	std::vector<double> phi; //sin^2(w / 2), w = 2pi f / sampleRate
+	std::vector<double> cosW, sinW, cos2W, sin2W;
+private:
+	double sampleRate = 0.0;
+
+	void resize(int numPoints, double newSampleRate);
+	void setFrequency(size_t i, double freq);
+};
+
+//b0, b1, b2, a1, a2 of a juce biquad, first order sections get b2 = a2 = 0
+BiquadCoefficients getBiquadCoefficients(const juce::dsp::IIR::Coefficients<float>& coefficients);
+
+/*
+ magnitudeSquared[i] *= |H(e^jw)|^2 of one biquad, for every point of the grid.
+ uses the sin^2(w/2) form, which stays accurate for low cuts far below the sample rate,
+ and has no branches or calls in the loop so it vectorizes.
+ */
+void multiplyByMagnitudeSquared(const FrequencyResponseGrid& grid, const BiquadCoefficients& coefficients, double* magnitudeSquared);
+
+//|H|^2 of every active (non bypassed) filter of the chain, for every point of the grid
+void getChainMagnitudeSquared(const MonoChain& chain, const FrequencyResponseGrid& grid, double* magnitudeSquared);
+
+/*
+ complex response of every band and of the whole chain over a FrequencyResponseGrid,
+ plus the chain's group delay. real and imaginary parts are kept apart so the loops vectorize.
+ */
+struct ChainResponse
+{
+	struct Complex
+	{
+		std::vector<double> re, im;
+
+		double getMagnitudeSquared(size_t i) const { return re[i] * re[i] + im[i] * im[i]; }
+		double getPhase(size_t i) const { return std::atan2(im[i], re[i]); }
+	};
+
+	void resize(int numPoints);
+
+	std::array<Complex, 3> bands; //indexed by ChainPositions, bypassed bands stay at 1
+	Complex total;
+	std::vector<double> groupDelaySamples;
+};
+
+/*
+ response *= H(e^jw) of one biquad and groupDelaySamples += its group delay, for every point of the grid.
+ the group delay of a polynomial P(z^-1) = sum p_k z^-k is Re(sum k p_k z^-k / P), the biquad's is the
+ numerator's minus the denominator's, so it comes out of the same terms as H without differentiating the phase.
+ */
+void multiplyByResponse(const FrequencyResponseGrid& grid, const BiquadCoefficients& coefficients,
+	ChainResponse::Complex& response, double* groupDelaySamples);
+
+//one pass over the active biquads of the chain
+void getChainResponse(const MonoChain& chain, const FrequencyResponseGrid& grid, ChainResponse& dest);
+
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
+
+/*
+ ramps the continuous parts of ChainSettings (frequencies, gain and Q) towards their targets.
+ the filters are redesigned from the ramped values once per stride instead of once per sample,
+ so automation moves the coefficients in small steps instead of one jump per host block.
+ slopes and bypass states are switched immediately.
+ */
+struct ChainSettingsSmoother
+{
+	void reset(double sampleRate, double rampLengthSeconds);
+	void setTarget(const ChainSettings& newTarget);
+	void snapToTarget(const ChainSettings& newTarget);
+
+	//advances the ramps by numSamples and returns the settings reached
+	ChainSettings skip(int numSamples);
+private:
+	ChainSettings target;
+
+	using FrequencySmoother = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>;
+	FrequencySmoother lowCutFreq, highCutFreq, peakFreq, peakQuality;
+	juce::SmoothedValue<float> peakGainInDecibels;
+};
+
+using SIMDFloat = juce::dsp::SIMDRegister<float>;
+using SIMDFilter = juce::dsp::IIR::Filter<SIMDFloat>;
+using SIMDCutFilter = juce::dsp::ProcessorChain<SIMDFilter, SIMDFilter, SIMDFilter, SIMDFilter>;
+using SIMDMonoChain = juce::dsp::ProcessorChain<SIMDCutFilter, SIMDFilter, SIMDCutFilter>;
+
+/*
+ runs the MonoChain topology over up to SIMDFloat::size() channels at once.
+ the channels are interleaved into the lanes of a SIMDRegister, so every biquad
+ processes all of them with a single set of (shared) coefficients.
+ */
+struct InterleavedChain
+{
+	void prepare(const juce::dsp::ProcessSpec& spec);
+	void process(const juce::dsp::AudioBlock<float>& block);
+
+	static constexpr size_t getMaxNumChannels() { return SIMDFloat::size(); }
+
+	SIMDMonoChain chain;
+private:
+	juce::HeapBlock<char> interleavedData;
+	juce::dsp::AudioBlock<SIMDFloat> interleaved;
+};
+/*
+ linear phase version of the chain: an FIR kernel with the MonoChain's magnitude response, symmetric around
+ numTaps / 2, run through juce::dsp::Convolution (uniformly partitioned, crossfades when the kernel changes).
+ the audio thread only posts ChainSettings, a background thread designs the kernels and hands them over.
+ */
+struct LinearPhaseChain : private juce::Thread
+{
+	LinearPhaseChain();
+	~LinearPhaseChain() override;
+
+	//audio must be stopped. only remembers the spec and drops the convolutions, see activate()
+	void prepare(const juce::dsp::ProcessSpec& spec);
+
+	/*
+	 builds the convolutions, designs the first kernel and starts the design thread, so nothing
+	 runs or allocates while linear phase is off. not real-time safe, but the audio thread may keep
+	 running as long as it doesn't touch the chain until isReady() returns true.
+	 */
+	void activate(const ChainSettings& chainSettings, int numTaps);
+	bool isReady() const { return ready.get(); }
+
+	//audio thread, never blocks. the new kernel fades in a few blocks later
+	void setSettings(const ChainSettings& chainSettings, int numTaps);
+	void process(const juce::dsp::AudioBlock<float>& block);
+
+	//clears the convolution history, real-time safe
+	void reset();
+
+	static int getLatencySamples(int numTaps) { return numTaps / 2; }
+
+	//numTaps must be a power of two, dest gets one channel of numTaps samples
+	static void designKernel(const ChainSettings& chainSettings, double sampleRate, int numTaps, juce::AudioBuffer<float>& dest);
+private:
+	void run() override;
+	void loadKernel(const ChainSettings& chainSettings, int numTaps);
+
+	juce::dsp::ConvolutionMessageQueue messageQueue;
+	juce::OwnedArray<juce::dsp::Convolution> convolutions; //one per channel pair, they all share messageQueue
+	juce::dsp::ProcessSpec spec{ 44100.0, 1, 0 };
+	juce::Atomic<bool> ready = false;
+
+	//written by the audio thread under a try-lock, picked up by run()
+	juce::SpinLock requestLock;
+	ChainSettings requestedSettings;
+	int requestedNumTaps = 0;
+	bool hasRequest = false;
+
+	//audio thread only, what was last handed to run()
+	ChainSettings postedSettings;
+	int postedNumTaps = 0;
+};
+
+/*
+ lock-free processBlock timing. the audio thread adds one entry per block, any other thread can read.
+ load is the block's wall time divided by its real-time budget (numSamples / sampleRate),
+ so 1.0 means the block took exactly as long as it lasts.
+ */
+struct DspLoadMeter
+{
+	static constexpr int numBuckets = 40;
+	static constexpr float bucketWidth = 0.05f; //the last bucket also holds everything above 200%
+
+	void reset();
+	void addBlock(double elapsedSeconds, double budgetSeconds);
+
+	float getLastLoad() const { return lastLoad.get(); }
+	float getMaxLoad() const { return maxLoad.get(); }
+	juce::int64 getNumBlocks() const { return numBlocks.get(); }
+	juce::int64 getNumOverruns() const { return numOverruns.get(); }
+	juce::int64 getBucketCount(int bucket) const { return histogram[(size_t)bucket].get(); }
+
+	//upper edge of the bucket holding the given percentile (0-100), from the histogram
+	float getPercentile(float percentile) const;
+private:
+	std::array<juce::Atomic<juce::int64>, numBuckets> histogram;
+	juce::Atomic<juce::int64> numBlocks = 0, numOverruns = 0;
+	juce::Atomic<float> lastLoad = 0.f, maxLoad = 0.f;
+};
+
 //==============================================================================
 /**
 */
-class SimpleEQAudioProcessor : public juce::AudioProcessor
+class SimpleEQAudioProcessor : public juce::AudioProcessor, private juce::AsyncUpdater
 {
 public:
 	//==============================================================================
@@ -255,6 +611,20 @@ public:
 	static juce::String paramPeakBypassed;
 	static juce::String paramHighCutBypassed;
 	static juce::String paramAnalyzerEnabled;
+	static juce::String paramSmoothing;
+	static juce::String paramAnalyzerResolution;
+	static juce::String paramAnalyzerOverlap;
+	static juce::String paramAnalyzerAveraging;
+	static juce::String paramAnalyzerAverageFrames;
+	static juce::String paramAnalyzerPeakDecay;
+	static juce::String paramAnalyzerView;
+	static juce::String paramShowBandCurves;
+	static juce::String paramShowPhase;
+	static juce::String paramShowGroupDelay;
+	static juce::String paramProcessingMode;
+	static juce::String paramLinearPhaseLength;
+	static juce::String paramOversampling;
+	static juce::String paramPeakDesign;
 
 
 	//==============================================================================
@@ -297,12 +667,36 @@ public:
 	SingleChannelSampleFifo<BlockType> leftChannelFifo{ Channel::Left };
 	SingleChannelSampleFifo<BlockType> rightChannelFifo{ Channel::Right };
 
+	//number of processBlock calls where no band needed to be redesigned
+	juce::int64 getNumSkippedFilterUpdates() const { return skippedFilterUpdates.get(); }
+
+	const DspLoadMeter& getDspLoadMeter() const { return dspLoadMeter; }
+
+	//the analyzer FIFOs are only fed while at least one consumer is attached and the analyzer is enabled
+	void setAnalyzerConsumerAttached(bool isAttached)
+	{
+		if (isAttached)
+			++analyzerConsumers;
+		else
+			--analyzerConsumers;
+	}
+
+	//1, 2 or 4. linear phase mode never oversamples
+	int getOversamplingFactor() const;
+
+	//the rate the IIR chain is designed for and runs at, for drawing the response it actually has
+	double getFilterSampleRate() const { return getSampleRate() * getOversamplingFactor(); }
+
+	//redesigns the bands whose settings differ from the last applied ones, or all of them when forced.
+	//returns true if at least one band was redesigned.
+	bool updateFilters(const ChainSettings& chainSettings, bool forceUpdate = false);
 
 private:
 	//==============================================================================
 
 
-	MonoChain leftChain, rightChain;
+	//one InterleavedChain per SIMDFloat::size() channels of the main bus, sized in prepareToPlay
+	juce::OwnedArray<InterleavedChain> chainPool;
 
 
 
@@ -314,7 +708,47 @@ private:
 	void updateLowCutFilters(const ChainSettings& chainSettings);
 	void updateHighCutFilters(const ChainSettings& chainSettings);
 
-	void updateFilters();
+	//runs the chains at the applied oversampling factor
+	void processChains(const juce::dsp::AudioBlock<float>& block);
+	void processChainsAtFilterRate(const juce::dsp::AudioBlock<float>& block);
+
+	//switches the chains to a new oversampling factor, audio thread
+	void applyOversamplingFactor(int factor);
+
+	//0 when smoothing is off, otherwise the number of samples between coefficient redesigns
+	int getSmoothingStride();
+
+	bool isLinearPhase() const { return processingMode->load() > 0.5f; }
+	//the minimum phase chain fills in until the linear phase one has been activated
+	bool isLinearPhaseRunning() const { return isLinearPhase() && linearPhaseChain.isReady(); }
+	int getLinearPhaseNumTaps() const;
+	int getProcessingLatency() const;
+
+	//processBlock triggers this when getProcessingLatency() no longer matches the reported latency
+	void handleAsyncUpdate() override;
+
+	ChainSettings appliedSettings;
+	ChainSettingsSmoother smoother;
+
+	CutCoefficients lowCutCoefficients, highCutCoefficients;
+	BiquadCoefficients peakCoefficients;
+	juce::Atomic<juce::int64> skippedFilterUpdates = 0;
+
+	DspLoadMeter dspLoadMeter;
+
+	LinearPhaseChain linearPhaseChain;
+	bool linearPhaseWasActive = false; //audio thread, to reset the convolutions when the mode is switched on
+	std::atomic<float>* processingMode = nullptr;
+	std::atomic<float>* linearPhaseLength = nullptr;
+
+	//[0] 2x, [1] 4x, both built in prepareToPlay so switching while playing doesn't allocate
+	juce::OwnedArray<juce::dsp::Oversampling<float>> oversamplers;
+	std::atomic<float>* oversampling = nullptr;
+	int appliedOversamplingFactor = 1;
+	size_t maxBlockSize = 1; //the samplesPerBlock prepareToPlay sized everything for
+
+	juce::Atomic<int> analyzerConsumers = 0;
+	std::atomic<float>* analyzerEnabled = nullptr;
 
 	juce::dsp::Oscillator<float> osc;
 